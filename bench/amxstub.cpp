@@ -0,0 +1,207 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "SDK/amx/amx.h"
+#include "SDK/plugincommon.h"
+#include "bench/amxstub.h"
+
+
+PLUGIN_EXPORT bool PLUGIN_CALL Load(void **ppData);
+PLUGIN_EXPORT void PLUGIN_CALL Unload();
+PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX *amx);
+PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX *amx);
+
+namespace amxstub
+{
+
+	AMX amx;
+
+	static const size_t DATA_SEGMENT_SIZE = 16 * 1024 * 1024;
+	static std::vector<unsigned char> base, data;
+	static cell heap_top = 0;
+	static std::vector<AMX_NATIVE_INFO> natives;
+	static void *amx_exports[PLUGIN_AMX_EXPORT_UTF8Put + 1];
+	static void *plugin_data[PLUGIN_DATA_CALLPUBLIC_GM + 1];
+
+	static void Unsupported()
+	{
+		fputs("amxstub: the plugin called an AMX function which isn't emulated.\n", stderr);
+		abort();
+	}
+
+	static void *StubLogprintf(const char *, ...)
+	{
+		return NULL;
+	}
+
+	static int AMXAPI StubRegister(AMX *, const AMX_NATIVE_INFO *list, int number)
+	{
+		for (int i = 0; i < number; ++i)
+			natives.push_back(list[i]);
+		return AMX_ERR_NONE;
+	}
+
+	static int AMXAPI StubFindPubVar(AMX *, const char *, cell *)
+	{
+		return AMX_ERR_NOTFOUND;
+	}
+
+	static int AMXAPI StubExec(AMX *, cell *, int)
+	{
+		return AMX_ERR_NONE;
+	}
+
+	static int AMXAPI StubGetAddr(AMX *, cell amx_addr, cell **phys_addr)
+	{
+		if (amx_addr < 0 || static_cast<size_t>(amx_addr) >= data.size())
+			return AMX_ERR_MEMACCESS;
+		*phys_addr = Addr(amx_addr);
+		return AMX_ERR_NONE;
+	}
+
+	static int AMXAPI StubRaiseError(AMX *amx, int error)
+	{
+		amx->error = error;
+		return AMX_ERR_NONE;
+	}
+
+	// Strings are always unpacked in the stand-in.
+	static int AMXAPI StubStrLen(const cell *cstring, int *length)
+	{
+		int len = 0;
+		while (cstring[len] != 0)
+			++len;
+		*length = len;
+		return AMX_ERR_NONE;
+	}
+
+	static int AMXAPI StubGetString(char *dest, const cell *source, int, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 1 < size && source[i] != 0; ++i)
+			dest[i] = static_cast<char>(source[i]);
+		if (size != 0)
+			dest[i] = '\0';
+		return AMX_ERR_NONE;
+	}
+
+	static int AMXAPI StubSetString(cell *dest, const char *source, int, int, size_t size)
+	{
+		size_t i = 0;
+		for (; i + 1 < size && source[i] != '\0'; ++i)
+			dest[i] = static_cast<cell>(static_cast<unsigned char>(source[i]));
+		if (size != 0)
+			dest[i] = 0;
+		return AMX_ERR_NONE;
+	}
+
+	bool Init()
+	{
+		for (size_t i = 0; i < sizeof(amx_exports) / sizeof(amx_exports[0]); ++i)
+			amx_exports[i] = reinterpret_cast<void *>(Unsupported);
+		amx_exports[PLUGIN_AMX_EXPORT_Register] = reinterpret_cast<void *>(StubRegister);
+		amx_exports[PLUGIN_AMX_EXPORT_FindPubVar] = reinterpret_cast<void *>(StubFindPubVar);
+		amx_exports[PLUGIN_AMX_EXPORT_Exec] = reinterpret_cast<void *>(StubExec);
+		amx_exports[PLUGIN_AMX_EXPORT_GetAddr] = reinterpret_cast<void *>(StubGetAddr);
+		amx_exports[PLUGIN_AMX_EXPORT_RaiseError] = reinterpret_cast<void *>(StubRaiseError);
+		amx_exports[PLUGIN_AMX_EXPORT_StrLen] = reinterpret_cast<void *>(StubStrLen);
+		amx_exports[PLUGIN_AMX_EXPORT_GetString] = reinterpret_cast<void *>(StubGetString);
+		amx_exports[PLUGIN_AMX_EXPORT_SetString] = reinterpret_cast<void *>(StubSetString);
+		plugin_data[PLUGIN_DATA_LOGPRINTF] = reinterpret_cast<void *>(StubLogprintf);
+		plugin_data[PLUGIN_DATA_AMX_EXPORTS] = amx_exports;
+
+		// An empty script: no code, no natives table, so the name of the
+		// current native always resolves to "(unknown)".
+		base.assign(sizeof(AMX_HEADER) + 4 * sizeof(cell), 0);
+		AMX_HEADER *hdr = reinterpret_cast<AMX_HEADER *>(base.data());
+		hdr->magic = AMX_MAGIC;
+		hdr->defsize = sizeof(AMX_FUNCSTUBNT);
+		hdr->cod = hdr->dat = sizeof(AMX_HEADER);
+		hdr->publics = hdr->natives = hdr->libraries = hdr->pubvars = hdr->tags = hdr->nametable = sizeof(AMX_HEADER);
+		data.assign(DATA_SEGMENT_SIZE, 0);
+		memset(&amx, 0, sizeof(amx));
+		amx.base = base.data();
+		amx.data = data.data();
+		heap_top = sizeof(cell); // keep address 0 unused
+
+		if (!Load(plugin_data))
+			return false;
+		return AmxLoad(&amx) == 1;
+	}
+
+	void Shutdown()
+	{
+		AmxUnload(&amx);
+		Unload();
+		natives.clear();
+	}
+
+	const AMX_NATIVE_INFO *GetNatives(int &num_natives)
+	{
+		num_natives = static_cast<int>(natives.size());
+		return natives.data();
+	}
+
+	AMX_NATIVE FindNative(const char *name)
+	{
+		for (size_t i = 0; i < natives.size(); ++i)
+			if (strcmp(natives[i].name, name) == 0)
+				return natives[i].func;
+		return NULL;
+	}
+
+	cell Alloc(size_t num_cells)
+	{
+		const cell amx_addr = heap_top;
+		if (static_cast<size_t>(heap_top) + num_cells * sizeof(cell) > data.size())
+		{
+			fputs("amxstub: the data segment is full.\n", stderr);
+			abort();
+		}
+		heap_top += static_cast<cell>(num_cells * sizeof(cell));
+		return amx_addr;
+	}
+
+	cell Mark()
+	{
+		return heap_top;
+	}
+
+	void Release(cell mark)
+	{
+		heap_top = mark;
+	}
+
+	cell AllocString(const std::string &str)
+	{
+		const cell amx_addr = Alloc(str.size() + 1);
+		StubSetString(Addr(amx_addr), str.c_str(), 0, 0, str.size() + 1);
+		return amx_addr;
+	}
+
+}
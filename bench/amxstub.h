@@ -0,0 +1,97 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#ifndef _AMXSTUB_H
+#define _AMXSTUB_H
+
+#include <cstddef>
+#include <initializer_list>
+#include <string>
+#include "SDK/amx/amx.h"
+
+
+/*
+	A minimal in-process stand-in for the SA-MP server, enough to load the
+	plugin and drive its natives with real 'params' arrays. It provides the
+	AMX export table the plugin calls through, a flat data segment for
+	arrays and references, and records the natives passed to amx_Register.
+*/
+namespace amxstub
+{
+
+	extern AMX amx;
+
+	/*
+		Loads the plugin and registers its natives into the stand-in AMX.
+	*/
+	bool Init();
+
+	/*
+		Unloads the stand-in AMX and the plugin.
+	*/
+	void Shutdown();
+
+	/*
+		Returns the natives registered by the plugin.
+	*/
+	const AMX_NATIVE_INFO *GetNatives(int &num_natives);
+	AMX_NATIVE FindNative(const char *name);
+
+	/*
+		Reserves cells in the data segment and returns their AMX address.
+		Release() frees everything reserved after the given mark.
+	*/
+	cell Alloc(size_t num_cells);
+	cell Mark();
+	void Release(cell mark);
+
+	/*
+		Returns the physical address of an AMX address.
+	*/
+	inline cell *Addr(cell amx_addr)
+	{
+		return reinterpret_cast<cell *>(amx.data + amx_addr);
+	}
+
+	/*
+		Stores an unpacked string in the data segment and returns its address.
+	*/
+	cell AllocString(const std::string &str);
+
+	/*
+		Calls a native with the given arguments, the way the AMX does.
+	*/
+	inline cell Call(AMX_NATIVE native, std::initializer_list<cell> args)
+	{
+		cell params[16];
+		params[0] = static_cast<cell>(args.size() * sizeof(cell));
+		cell *param = &params[1];
+		for (auto arg : args)
+			*param++ = arg;
+		return native(&amx, params);
+	}
+
+}
+
+
+#endif // _AMXSTUB_H
@@ -0,0 +1,616 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+/*
+	Microbenchmarks of every native registered by the plugin, run in-process
+	against the amxstub stand-in. For each native and vector size it prints
+	the time and the number of heap allocations per call. It fails if a
+	native has no benchmark, or if a tracked aggregate disagrees with a scan.
+
+	Usage: vectors_bench [native name filter]
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench/amxstub.h"
+#include "denseset.h"
+#include "simd.h"
+
+using amxstub::Call;
+
+
+static size_t num_allocations = 0;
+
+void *operator new(size_t size)
+{
+	++num_allocations;
+	if (void *ptr = malloc(size ? size : 1))
+		return ptr;
+	throw std::bad_alloc();
+}
+
+// Used by the temporary buffers of std::stable_sort.
+void *operator new(size_t size, const std::nothrow_t &) noexcept
+{
+	++num_allocations;
+	return malloc(size ? size : 1);
+}
+
+void operator delete(void *ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept
+{
+	free(ptr);
+}
+
+// Every native is called at least this many times per size, unless the
+// setup work between rounds would exceed the budget below.
+static const size_t MIN_CALLS = 200000;
+static const size_t SETUP_BUDGET = 4000000;
+static const size_t SIZES[] = { 10, 1000, 100000 };
+
+static const char *filter = NULL;
+static std::set<std::string> measured;
+static volatile cell sink;
+
+static AMX_NATIVE Native(const char *name)
+{
+	AMX_NATIVE native = amxstub::FindNative(name);
+	if (native == NULL)
+	{
+		fprintf(stderr, "The native %s isn't registered by the plugin.\n", name);
+		exit(EXIT_FAILURE);
+	}
+	return native;
+}
+
+// Distinct, well spread values: multiplying by an odd constant is a bijection.
+static cell Value(size_t i)
+{
+	return static_cast<cell>(static_cast<uint32_t>(i) * 2654435761u);
+}
+
+static cell MakeVector(size_t size, bool sorted = false)
+{
+	const cell vector = Call(Native(sorted ? "Vector_CreateSorted" : "Vector_Create"), {});
+	const cell mark = amxstub::Mark();
+	const cell src = amxstub::Alloc(size);
+	for (size_t i = 0; i < size; ++i)
+		amxstub::Addr(src)[i] = Value(i);
+	Call(Native("Vector_Assign"), { vector, src, static_cast<cell>(size) });
+	amxstub::Release(mark);
+	return vector;
+}
+
+static void Fill(cell vector, size_t size)
+{
+	const cell mark = amxstub::Mark();
+	const cell src = amxstub::Alloc(size);
+	for (size_t i = 0; i < size; ++i)
+		amxstub::Addr(src)[i] = Value(i);
+	Call(Native("Vector_Assign"), { vector, src, static_cast<cell>(size) });
+	amxstub::Release(mark);
+}
+
+/*
+	Runs 'setup' untimed, then 'call' for calls_per_round times, for as many
+	rounds as needed to reach MIN_CALLS, and prints the averages.
+*/
+template <typename Setup, typename Op>
+static void Measure(const char *native, const char *variant, size_t size, size_t calls_per_round, Setup setup, Op call)
+{
+	measured.insert(native);
+	if (filter != NULL && strstr(native, filter) == NULL)
+		return;
+	if (calls_per_round == 0)
+		calls_per_round = 1;
+	size_t rounds = (MIN_CALLS + calls_per_round - 1) / calls_per_round;
+	rounds = std::max<size_t>(1, std::min(rounds, SETUP_BUDGET / size));
+
+	double total_ns = 0.0;
+	size_t total_allocations = 0;
+	for (size_t round = 0; round < rounds; ++round)
+	{
+		setup();
+		const size_t allocations = num_allocations;
+		const auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < calls_per_round; ++i)
+			sink = call(i);
+		const auto end = std::chrono::steady_clock::now();
+		total_allocations += num_allocations - allocations;
+		total_ns += std::chrono::duration<double, std::nano>(end - start).count();
+	}
+	const double calls = static_cast<double>(rounds * calls_per_round);
+	char name[64];
+	snprintf(name, sizeof(name), "%s%s%s", native, variant[0] ? " " : "", variant);
+	printf("%-36s %8u %12.1f %12.3f\n", name, static_cast<unsigned int>(size), total_ns / calls, total_allocations / calls);
+}
+
+template <typename Op>
+static void Measure(const char *native, const char *variant, size_t size, size_t calls_per_round, Op call)
+{
+	Measure(native, variant, size, calls_per_round, [] {}, call);
+}
+
+static cell FloatBits(float value)
+{
+	cell bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// A tracked Float sum must still match a scan once a large value is removed.
+static bool CheckTrackedFloatSum()
+{
+	AMX_NATIVE add = Native("Vector_Add"), remove = Native("Vector_Remove"), sum = Native("Vector_Sum");
+	const cell tracked = Call(Native("Vector_Create"), { 1 }), scanned = Call(Native("Vector_Create"), { 1 });
+	Call(Native("Vector_TrackAggregates"), { tracked, 1 });
+	const float values[] = { 1e30f, 1.0f, -2.5e20f, 0.25f };
+	for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+	{
+		Call(add, { tracked, FloatBits(values[i]) });
+		Call(add, { scanned, FloatBits(values[i]) });
+	}
+	Call(remove, { tracked, FloatBits(1e30f) });
+	Call(remove, { scanned, FloatBits(1e30f) });
+	Call(remove, { tracked, FloatBits(-2.5e20f) });
+	Call(remove, { scanned, FloatBits(-2.5e20f) });
+	const cell expected = Call(sum, { scanned }), actual = Call(sum, { tracked });
+	Call(Native("Vector_Destroy"), { tracked });
+	Call(Native("Vector_Destroy"), { scanned });
+	if (actual == expected && expected == FloatBits(1.25f))
+		return true;
+	fputs("The tracked sum of a Float vector disagrees with a scan.\n", stderr);
+	return false;
+}
+
+static void RunCases(size_t n)
+{
+	const cell mark = amxstub::Mark();
+	const cell vector = MakeVector(n), sorted = MakeVector(n, true);
+	const cell scratch = Call(Native("Vector_Create"), {});
+	const cell ref_a = amxstub::Alloc(1), ref_b = amxstub::Alloc(1);
+	const cell array = amxstub::Alloc(n);
+	for (size_t i = 0; i < n; ++i)
+		amxstub::Addr(array)[i] = Value(i);
+	const cell shared_name = amxstub::AllocString("bench");
+	Call(Native("Vector_CreateShared"), { shared_name });
+
+	// Lifetime
+	{
+		std::vector<cell> created;
+		auto destroy_created = [&] {
+			for (size_t i = 0; i < created.size(); ++i)
+				Call(Native("Vector_Destroy"), { created[i] });
+			created.clear();
+		};
+		AMX_NATIVE create = Native("Vector_Create"), create_sorted = Native("Vector_CreateSorted"), destroy = Native("Vector_Destroy");
+		Measure("Vector_Create", "", n, n, destroy_created, [&](size_t) { created.push_back(Call(create, {})); return 0; });
+		Measure("Vector_CreateSorted", "", n, n, destroy_created, [&](size_t) { created.push_back(Call(create_sorted, {})); return 0; });
+		destroy_created();
+		Measure("Vector_Destroy", "", n, n, [&] {
+			created.clear();
+			for (size_t i = 0; i < n; ++i)
+				created.push_back(Call(create, {}));
+		}, [&](size_t i) { return Call(destroy, { created[i] }); });
+		created.clear();
+		AMX_NATIVE create_shared = Native("Vector_CreateShared"), find_shared = Native("Vector_FindShared");
+		Measure("Vector_CreateShared", "existing", n, n, [&](size_t) { return Call(create_shared, { shared_name }); });
+		Measure("Vector_FindShared", "", n, n, [&](size_t) { return Call(find_shared, { shared_name }); });
+		AMX_NATIVE get_type = Native("Vector_GetType");
+		Measure("Vector_GetType", "", n, n, [&](size_t) { return Call(get_type, { vector }); });
+		AMX_NATIVE debug_mode = Native("Vector_DebugMode");
+		Measure("Vector_DebugMode", "", n, n, [&](size_t) { return Call(debug_mode, { 0 }); });
+		AMX_NATIVE trace_native = Native("Vector_TraceNative");
+		const cell traced_name = amxstub::AllocString("Vector_Add");
+		Measure("Vector_TraceNative", "off", n, n, [&](size_t) { return Call(trace_native, { traced_name, 0, 1 }); });
+		AMX_NATIVE get_stats = Native("Vector_GetStats"), reset_stats = Native("Vector_ResetStats");
+		const cell stats_refs = amxstub::Alloc(5);
+		Measure("Vector_GetStats", "", n, n, [&](size_t) {
+			const cell size = static_cast<cell>(sizeof(cell));
+			return Call(get_stats, { traced_name, stats_refs, stats_refs + 1 * size, stats_refs + 2 * size, stats_refs + 3 * size, stats_refs + 4 * size });
+		});
+		Measure("Vector_ResetStats", "", n, n, [&](size_t) { return Call(reset_stats, {}); });
+		// Every call writes a file, the setup budget keeps it to a few calls at the largest size.
+		if (n == SIZES[sizeof(SIZES) / sizeof(SIZES[0]) - 1])
+		{
+			AMX_NATIVE dump_stats = Native("Vector_DumpStats");
+			const cell stats_file = amxstub::AllocString("bench_stats.log");
+			Measure("Vector_DumpStats", "", n, 1, [&](size_t) { return Call(dump_stats, { stats_file }); });
+			remove("bench_stats.log");
+		}
+		else
+			measured.insert("Vector_DumpStats");
+	}
+
+	// Queries
+	{
+		const char *queries[] = { "Vector_Size", "Vector_Odd", "Vector_Even", "Vector_Empty", "Vector_Random",
+			"Vector_Begin", "Vector_End", "Vector_First", "Vector_Last", "Vector_IterBegin" };
+		for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); ++q)
+		{
+			AMX_NATIVE native = Native(queries[q]);
+			Measure(queries[q], "", n, n, [&](size_t) { return Call(native, { vector }); });
+		}
+		const char *by_value[] = { "Vector_Next", "Vector_Prev", "Vector_FindIndex" };
+		for (size_t q = 0; q < sizeof(by_value) / sizeof(by_value[0]); ++q)
+		{
+			AMX_NATIVE native = Native(by_value[q]);
+			Measure(by_value[q], "", n, n, [&](size_t i) { return Call(native, { vector, Value(i) }); });
+		}
+		AMX_NATIVE find_index = Native("Vector_FindIndex"), find_value = Native("Vector_FindValue");
+		Measure("Vector_FindIndex", "sorted", n, n, [&](size_t i) { return Call(find_index, { sorted, Value(i) }); });
+		// Up to DenseSet::SMALL_SIZE elements are stored inline and scanned linearly.
+		const cell small = MakeVector(std::min<size_t>(n, DenseSet::SMALL_SIZE));
+		Measure("Vector_FindIndex", "small", n, n, [&](size_t i) { return Call(find_index, { small, Value(i % DenseSet::SMALL_SIZE) }); });
+		Measure("Vector_FindIndex", "small miss", n, n, [&](size_t i) { return Call(find_index, { small, static_cast<cell>(i) }); });
+		Measure("Vector_FindValue", "", n, n, [&](size_t i) { return Call(find_value, { vector, static_cast<cell>(i) }); });
+		AMX_NATIVE lower_bound = Native("Vector_LowerBound"), upper_bound = Native("Vector_UpperBound"), count_in_range = Native("Vector_CountInRange");
+		Measure("Vector_LowerBound", "", n, n, [&](size_t i) { return Call(lower_bound, { sorted, Value(i) }); });
+		Measure("Vector_UpperBound", "", n, n, [&](size_t i) { return Call(upper_bound, { sorted, Value(i) }); });
+		Measure("Vector_CountInRange", "", n, 1, [&](size_t) { return Call(count_in_range, { vector, -1000000000, 1000000000 }); });
+		const char *aggregates[] = { "Vector_Sum", "Vector_Min", "Vector_Max", "Vector_Average" };
+		for (size_t q = 0; q < sizeof(aggregates) / sizeof(aggregates[0]); ++q)
+		{
+			AMX_NATIVE native = Native(aggregates[q]);
+			Measure(aggregates[q], "", n, 1, [&](size_t) { return Call(native, { vector }); });
+		}
+		AMX_NATIVE max = Native("Vector_Max");
+		Measure("Vector_Max", "sorted", n, n, [&](size_t) { return Call(max, { sorted }); });
+		AMX_NATIVE track = Native("Vector_TrackAggregates");
+		Measure("Vector_TrackAggregates", "", n, 1, [&](size_t) { return Call(track, { vector, 1 }); });
+		Call(track, { vector, 1 });
+		AMX_NATIVE tracked_sum = Native("Vector_Sum");
+		Measure("Vector_Sum", "tracked", n, n, [&](size_t) { return Call(tracked_sum, { vector }); });
+		Measure("Vector_Max", "tracked", n, n, [&](size_t) { return Call(max, { vector }); });
+		Call(track, { vector, 0 });
+		// The same bits stored as Floats: only the sum needs a kernel of its own.
+		const cell floats = Call(Native("Vector_Create"), { 1 }); // VECTOR_FLOAT
+		Call(Native("Vector_Assign"), { floats, array, static_cast<cell>(n) });
+		Measure("Vector_Sum", "float", n, 1, [&](size_t) { return Call(tracked_sum, { floats }); });
+		Measure("Vector_Max", "float", n, 1, [&](size_t) { return Call(max, { floats }); });
+		Measure("Vector_FindIndex", "float", n, n, [&](size_t i) { return Call(find_index, { floats, Value(i) }); });
+		// The scan kernels against the plain loop, to keep the SIMD thresholds honest.
+		const simd::Level level = simd::GetLevel();
+		simd::SetLevel(simd::LEVEL_SCALAR);
+		Measure("Vector_FindIndex", "small miss scalar", n, n, [&](size_t i) { return Call(find_index, { small, static_cast<cell>(i) }); });
+		Measure("Vector_CountInRange", "scalar", n, 1, [&](size_t) { return Call(count_in_range, { vector, -1000000000, 1000000000 }); });
+		AMX_NATIVE sum = Native("Vector_Sum");
+		Measure("Vector_Sum", "scalar", n, 1, [&](size_t) { return Call(sum, { vector }); });
+		Measure("Vector_Sum", "float scalar", n, 1, [&](size_t) { return Call(sum, { floats }); });
+		Measure("Vector_Max", "scalar", n, 1, [&](size_t) { return Call(max, { vector }); });
+		simd::SetLevel(level);
+		Measure("Vector_CountInRange", "sorted", n, n, [&](size_t) { return Call(count_in_range, { sorted, -1000000000, 1000000000 }); });
+		Call(Native("Vector_Destroy"), { floats });
+	}
+
+	// Iteration and bulk copies
+	{
+		AMX_NATIVE iter_next = Native("Vector_IterNext");
+		Measure("Vector_IterNext", "", n, n, [&] { *amxstub::Addr(ref_a) = 0; },
+			[&](size_t) { return Call(iter_next, { vector, ref_a, ref_b }); });
+		AMX_NATIVE to_array = Native("Vector_ToArray");
+		Measure("Vector_ToArray", "", n, 1, [&](size_t) { return Call(to_array, { vector, array, static_cast<cell>(n), 0 }); });
+		AMX_NATIVE add_array = Native("Vector_AddArray"), assign = Native("Vector_Assign");
+		Measure("Vector_AddArray", "", n, 1, [&] { Call(Native("Vector_Clear"), { scratch }); },
+			[&](size_t) { return Call(add_array, { scratch, array, static_cast<cell>(n) }); });
+		Measure("Vector_Assign", "", n, 1, [&](size_t) { return Call(assign, { scratch, array, static_cast<cell>(n) }); });
+		// One call for n operations, compare with n calls of Vector_Add / Vector_Remove.
+		AMX_NATIVE batch = Native("Vector_Batch"), clear = Native("Vector_Clear");
+		const cell adds = amxstub::Alloc(3 * n);
+		for (size_t i = 0; i < n; ++i)
+		{
+			amxstub::Addr(adds)[3 * i] = 1; // VECTOR_OP_ADD
+			amxstub::Addr(adds)[3 * i + 1] = scratch;
+			amxstub::Addr(adds)[3 * i + 2] = Value(i);
+		}
+		Measure("Vector_Batch", "adds", n, 1, [&] { Call(clear, { scratch }); },
+			[&](size_t) { return Call(batch, { adds, static_cast<cell>(3 * n) }); });
+		const cell moved = Call(Native("Vector_Create"), {});
+		const cell moves = amxstub::Alloc(6 * n);
+		for (size_t i = 0; i < n; ++i)
+		{ // Alternates between two vectors, so no two adds are appended together.
+			cell *op = amxstub::Addr(moves) + 6 * i;
+			op[0] = 2; // VECTOR_OP_REMOVE
+			op[1] = scratch;
+			op[2] = Value(i);
+			op[3] = 1; // VECTOR_OP_ADD
+			op[4] = moved;
+			op[5] = Value(i);
+		}
+		Measure("Vector_Batch", "mixed", n, 1, [&] { Fill(scratch, n); Call(clear, { moved }); },
+			[&](size_t) { return Call(batch, { moves, static_cast<cell>(6 * n) }); });
+		Call(Native("Vector_Destroy"), { moved });
+	}
+
+	// Mutations
+	{
+		AMX_NATIVE add = Native("Vector_Add"), clear = Native("Vector_Clear");
+		Measure("Vector_Add", "", n, n, [&] { Call(clear, { scratch }); }, [&](size_t i) { return Call(add, { scratch, Value(i) }); });
+		const cell scratch_sorted = Call(Native("Vector_CreateSorted"), {});
+		Measure("Vector_Add", "sorted", n, std::min<size_t>(n, 10000), [&] { Call(clear, { scratch_sorted }); },
+			[&](size_t i) { return Call(add, { scratch_sorted, Value(i) }); });
+		const cell scratch_tracked = Call(Native("Vector_Create"), {});
+		Call(Native("Vector_TrackAggregates"), { scratch_tracked, 1 });
+		Measure("Vector_Add", "tracked", n, n, [&] { Call(clear, { scratch_tracked }); },
+			[&](size_t i) { return Call(add, { scratch_tracked, Value(i) }); });
+		Call(Native("Vector_Destroy"), { scratch_tracked });
+		Measure("Vector_Clear", "", n, 1, [&] { Fill(scratch, n); }, [&](size_t) { return Call(clear, { scratch }); });
+		AMX_NATIVE reserve = Native("Vector_Reserve"), shrink_to_fit = Native("Vector_ShrinkToFit");
+		Measure("Vector_Add", "reserved", n, n, [&] { Call(clear, { scratch }); Call(shrink_to_fit, { scratch }); Call(reserve, { scratch, static_cast<cell>(n) }); },
+			[&](size_t i) { return Call(add, { scratch, Value(i) }); });
+		Measure("Vector_Reserve", "", n, 1, [&] { Call(clear, { scratch }); Call(shrink_to_fit, { scratch }); },
+			[&](size_t) { return Call(reserve, { scratch, static_cast<cell>(n) }); });
+		Measure("Vector_ShrinkToFit", "", n, 1, [&] { Fill(scratch, n); Call(reserve, { scratch, static_cast<cell>(2 * n) }); },
+			[&](size_t) { return Call(shrink_to_fit, { scratch }); });
+		AMX_NATIVE capacity = Native("Vector_Capacity"), memory_usage = Native("Vector_MemoryUsage");
+		Measure("Vector_Capacity", "", n, n, [&](size_t) { return Call(capacity, { vector }); });
+		Measure("Vector_MemoryUsage", "", n, 1, [&](size_t) { return Call(memory_usage, {}); });
+		AMX_NATIVE pool_stats = Native("Vector_PoolStats");
+		const cell pool_refs = amxstub::Alloc(4), cell_size = static_cast<cell>(sizeof(cell));
+		Measure("Vector_PoolStats", "", n, n, [&](size_t) { return Call(pool_stats, { pool_refs, pool_refs + cell_size, pool_refs + 2 * cell_size, pool_refs + 3 * cell_size }); });
+		AMX_NATIVE remove = Native("Vector_Remove"), erase = Native("Vector_Delete"), iter_remove = Native("Vector_IterRemove");
+		Measure("Vector_Remove", "", n, n, [&] { Fill(scratch, n); }, [&](size_t i) { return Call(remove, { scratch, Value(i) }); });
+		Measure("Vector_Delete", "", n, n, [&] { Fill(scratch, n); }, [&](size_t) { return Call(erase, { scratch, 0 }); });
+		Measure("Vector_IterRemove", "", n, n, [&] { Fill(scratch, n); *amxstub::Addr(ref_a) = static_cast<cell>(n); },
+			[&](size_t) { return Call(iter_remove, { scratch, ref_a }); });
+		AMX_NATIVE pop_back = Native("Vector_PopBack"), pop_front = Native("Vector_PopFront");
+		Measure("Vector_PopBack", "", n, n, [&] { Fill(scratch, n); }, [&](size_t) { return Call(pop_back, { scratch }); });
+		Measure("Vector_PopFront", "", n, std::min<size_t>(n, 1000), [&] { Fill(scratch, n); }, [&](size_t) { return Call(pop_front, { scratch }); });
+		AMX_NATIVE replace = Native("Vector_Replace"), replace_index = Native("Vector_ReplaceIndex");
+		Measure("Vector_Replace", "", n, n, [&] { Fill(scratch, n); }, [&](size_t i) { return Call(replace, { scratch, Value(i), Value(i + n) }); });
+		Measure("Vector_ReplaceIndex", "", n, n, [&] { Fill(scratch, n); }, [&](size_t i) { return Call(replace_index, { scratch, static_cast<cell>(i), Value(i + n) }); });
+		Call(Native("Vector_Destroy"), { scratch_sorted });
+	}
+
+	// String vectors
+	{
+		std::vector<cell> names(n);
+		char name[16];
+		for (size_t i = 0; i < n; ++i)
+		{
+			snprintf(name, sizeof(name), "s%u", static_cast<unsigned int>(Value(i)) >> 8);
+			names[i] = amxstub::AllocString(name);
+		}
+		const cell strings = Call(Native("Vector_Create"), { 2 }); // VECTOR_STRING
+		AMX_NATIVE add_string = Native("Vector_AddString"), clear = Native("Vector_Clear");
+		Measure("Vector_AddString", "", n, n, [&] { Call(clear, { strings }); }, [&](size_t i) { return Call(add_string, { strings, names[i] }); });
+		AMX_NATIVE find_string = Native("Vector_FindString"), get_string = Native("Vector_GetString");
+		Measure("Vector_FindString", "", n, n, [&](size_t i) { return Call(find_string, { strings, names[i] }); });
+		const cell dest = amxstub::Alloc(16);
+		Measure("Vector_GetString", "", n, n, [&](size_t i) { return Call(get_string, { strings, static_cast<cell>(i), dest, 16 }); });
+		AMX_NATIVE sort = Native("Vector_Sort");
+		Measure("Vector_Sort", "string", n, 1, [&] {
+			Call(clear, { strings });
+			for (size_t i = 0; i < n; ++i)
+				Call(add_string, { strings, names[i] });
+		}, [&](size_t) { return Call(sort, { strings, 0 }); });
+		Call(Native("Vector_Destroy"), { strings });
+	}
+
+	// Record vectors, 60 fields like a per-player data table
+	{
+		const size_t fields = 60;
+		AMX_NATIVE create_records = Native("Vector_CreateRecords"), destroy = Native("Vector_Destroy");
+		std::vector<cell> created;
+		Measure("Vector_CreateRecords", "", n, n, [&] {
+			for (size_t i = 0; i < created.size(); ++i)
+				Call(destroy, { created[i] });
+			created.clear();
+		}, [&](size_t) { created.push_back(Call(create_records, { static_cast<cell>(fields) })); return 0; });
+		for (size_t i = 0; i < created.size(); ++i)
+			Call(destroy, { created[i] });
+
+		const cell records = Call(create_records, { static_cast<cell>(fields) });
+		const cell row = amxstub::Alloc(fields);
+		AMX_NATIVE add_record = Native("Vector_AddRecord"), clear = Native("Vector_Clear");
+		auto fill = [&] {
+			Call(clear, { records });
+			for (size_t i = 0; i < n; ++i)
+			{
+				for (size_t f = 0; f < fields; ++f)
+					amxstub::Addr(row)[f] = Value(i * fields + f);
+				Call(add_record, { records, row, static_cast<cell>(fields) });
+			}
+		};
+		Measure("Vector_AddRecord", "", n, n, [&] { Call(clear, { records }); }, [&](size_t) { return Call(add_record, { records, row, static_cast<cell>(fields) }); });
+		fill();
+		AMX_NATIVE get_record = Native("Vector_GetRecord"), set_record = Native("Vector_SetRecord");
+		Measure("Vector_GetRecord", "", n, n, [&](size_t i) { return Call(get_record, { records, static_cast<cell>(i), row, static_cast<cell>(fields) }); });
+		Measure("Vector_SetRecord", "", n, n, [&](size_t i) { return Call(set_record, { records, static_cast<cell>(i), row, static_cast<cell>(fields) }); });
+		AMX_NATIVE get_field = Native("Vector_GetField"), set_field = Native("Vector_SetField");
+		Measure("Vector_GetField", "", n, n, [&](size_t i) { return Call(get_field, { records, static_cast<cell>(i), static_cast<cell>(i % fields) }); });
+		Measure("Vector_SetField", "", n, n, [&](size_t i) { return Call(set_field, { records, static_cast<cell>(i), static_cast<cell>(i % fields), Value(i) }); });
+		AMX_NATIVE find_record = Native("Vector_FindRecord");
+		Measure("Vector_FindRecord", "miss", n, 1, [&](size_t) { return Call(find_record, { records, 7, 1, 0 }); });
+		AMX_NATIVE sort_records = Native("Vector_SortRecords");
+		Measure("Vector_SortRecords", "", n, 1, fill, [&](size_t) { return Call(sort_records, { records, 7, 0, 0 }); });
+		AMX_NATIVE delete_record = Native("Vector_DeleteRecord");
+		Measure("Vector_DeleteRecord", "", n, n, fill, [&](size_t) { return Call(delete_record, { records, 0 }); });
+		Call(destroy, { records });
+	}
+
+	// Maps
+	{
+		std::vector<cell> created;
+		AMX_NATIVE create = Native("Map_Create"), destroy = Native("Map_Destroy");
+		Measure("Map_Create", "", n, n, [&] {
+			for (size_t i = 0; i < created.size(); ++i)
+				Call(destroy, { created[i] });
+			created.clear();
+		}, [&](size_t) { created.push_back(Call(create, {})); return 0; });
+		Measure("Map_Destroy", "", n, n, [&] {
+			created.clear();
+			for (size_t i = 0; i < n; ++i)
+				created.push_back(Call(create, {}));
+		}, [&](size_t i) { return Call(destroy, { created[i] }); });
+
+		const cell map = Call(create, {});
+		AMX_NATIVE set = Native("Map_Set"), clear = Native("Map_Clear");
+		auto fill = [&] {
+			Call(clear, { map });
+			for (size_t i = 0; i < n; ++i)
+				Call(set, { map, Value(i), static_cast<cell>(i) });
+		};
+		Measure("Map_Set", "new", n, n, [&] { Call(clear, { map }); }, [&](size_t i) { return Call(set, { map, Value(i), static_cast<cell>(i) }); });
+		Measure("Map_Set", "existing", n, n, [&](size_t i) { return Call(set, { map, Value(i), static_cast<cell>(i + 1) }); });
+		AMX_NATIVE get = Native("Map_Get"), contains = Native("Map_Contains"), size = Native("Map_Size");
+		Measure("Map_Get", "", n, n, [&](size_t i) { return Call(get, { map, Value(i), ref_a }); });
+		Measure("Map_Contains", "", n, n, [&](size_t i) { return Call(contains, { map, Value(i + n) }); });
+		Measure("Map_Size", "", n, n, [&](size_t) { return Call(size, { map }); });
+		AMX_NATIVE iter_next = Native("Map_IterNext"), iter_remove = Native("Map_IterRemove");
+		Measure("Map_IterNext", "", n, n, [&] { *amxstub::Addr(ref_a) = 0; }, [&](size_t) { return Call(iter_next, { map, ref_a, ref_b, ref_b }); });
+		Measure("Map_IterRemove", "", n, n, [&] { fill(); *amxstub::Addr(ref_a) = static_cast<cell>(n); },
+			[&](size_t) { return Call(iter_remove, { map, ref_a }); });
+		AMX_NATIVE remove = Native("Map_Remove");
+		Measure("Map_Remove", "", n, n, fill, [&](size_t i) { return Call(remove, { map, Value(i) }); });
+		Measure("Map_Clear", "", n, 1, fill, [&](size_t) { return Call(clear, { map }); });
+
+		// Arrays of 8 cells, a typical enum of per-player data.
+		AMX_NATIVE set_array = Native("Map_SetArray"), get_array = Native("Map_GetArray");
+		Measure("Map_SetArray", "", n, n, [&] { Call(clear, { map }); }, [&](size_t i) { return Call(set_array, { map, Value(i), array, 8 }); });
+		const cell dest = amxstub::Alloc(8);
+		Measure("Map_GetArray", "", n, n, [&](size_t i) { return Call(get_array, { map, Value(i), dest, 8 }); });
+		Call(destroy, { map });
+	}
+
+	// Priority queues
+	{
+		std::vector<cell> created;
+		AMX_NATIVE create = Native("Heap_Create"), destroy = Native("Heap_Destroy");
+		Measure("Heap_Create", "", n, n, [&] {
+			for (size_t i = 0; i < created.size(); ++i)
+				Call(destroy, { created[i] });
+			created.clear();
+		}, [&](size_t) { created.push_back(Call(create, {})); return 0; });
+		Measure("Heap_Destroy", "", n, n, [&] {
+			created.clear();
+			for (size_t i = 0; i < n; ++i)
+				created.push_back(Call(create, {}));
+		}, [&](size_t i) { return Call(destroy, { created[i] }); });
+
+		// Priorities in scrambled order, like timers scheduled at random delays.
+		const cell heap = Call(create, {});
+		AMX_NATIVE push = Native("Heap_Push"), clear = Native("Heap_Clear");
+		auto fill = [&] {
+			Call(clear, { heap });
+			for (size_t i = 0; i < n; ++i)
+				Call(push, { heap, static_cast<cell>(i), Value(i) & 0xFFFFFF });
+		};
+		Measure("Heap_Push", "", n, n, [&] { Call(clear, { heap }); }, [&](size_t i) { return Call(push, { heap, static_cast<cell>(i), Value(i) & 0xFFFFFF }); });
+		AMX_NATIVE peek = Native("Heap_Peek"), pop = Native("Heap_Pop");
+		Measure("Heap_Peek", "", n, n, [&](size_t) { return Call(peek, { heap, ref_a, ref_b }); });
+		Measure("Heap_Pop", "", n, n, fill, [&](size_t) { return Call(pop, { heap, ref_a, ref_b }); });
+		AMX_NATIVE decrease_key = Native("Heap_DecreaseKey");
+		Measure("Heap_DecreaseKey", "", n, n, fill, [&](size_t i) { return Call(decrease_key, { heap, static_cast<cell>(i), -static_cast<cell>(i) }); });
+		AMX_NATIVE contains = Native("Heap_Contains"), get_priority = Native("Heap_GetPriority"), size = Native("Heap_Size");
+		Measure("Heap_Contains", "", n, n, [&](size_t i) { return Call(contains, { heap, static_cast<cell>(i) }); });
+		Measure("Heap_GetPriority", "", n, n, [&](size_t i) { return Call(get_priority, { heap, static_cast<cell>(i), ref_a }); });
+		Measure("Heap_Size", "", n, n, [&](size_t) { return Call(size, { heap }); });
+		AMX_NATIVE remove = Native("Heap_Remove");
+		Measure("Heap_Remove", "", n, n, fill, [&](size_t i) { return Call(remove, { heap, static_cast<cell>(i) }); });
+		Measure("Heap_Clear", "", n, 1, fill, [&](size_t) { return Call(clear, { heap }); });
+		Call(destroy, { heap });
+	}
+
+	// Set algebra and sorting
+	{
+		const cell other = Call(Native("Vector_Create"), {});
+		Fill(other, n);
+		for (size_t i = 0; i < n / 2; ++i)
+			Call(Native("Vector_ReplaceIndex"), { other, static_cast<cell>(i), Value(i + n) });
+		const char *operations[] = { "Vector_Union", "Vector_Intersect", "Vector_Difference" };
+		for (size_t o = 0; o < sizeof(operations) / sizeof(operations[0]); ++o)
+		{
+			AMX_NATIVE native = Native(operations[o]);
+			Measure(operations[o], "", n, 1, [&](size_t) { return Call(native, { vector, other, scratch }); });
+		}
+		Call(Native("Vector_Destroy"), { other });
+		AMX_NATIVE sort = Native("Vector_Sort"), sort_by_key = Native("Vector_SortByKey");
+		Measure("Vector_Sort", "", n, 1, [&] { Fill(scratch, n); }, [&](size_t) { return Call(sort, { scratch, 0 }); });
+		const cell keys = amxstub::Alloc(n);
+		for (size_t i = 0; i < n; ++i)
+			amxstub::Addr(keys)[i] = Value(i * 31);
+		Measure("Vector_SortByKey", "", n, 1, [&] {
+			for (size_t i = 0; i < n; ++i)
+				amxstub::Addr(array)[i] = static_cast<cell>(n - 1 - i);
+			Call(Native("Vector_Assign"), { scratch, array, static_cast<cell>(n) });
+		}, [&](size_t) { return Call(sort_by_key, { scratch, keys, static_cast<cell>(n), 1 }); });
+	}
+
+	Call(Native("Vector_Destroy"), { vector });
+	Call(Native("Vector_Destroy"), { sorted });
+	Call(Native("Vector_Destroy"), { scratch });
+	amxstub::Release(mark);
+}
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1)
+		filter = argv[1];
+	if (!amxstub::Init())
+	{
+		fputs("The plugin failed to load.\n", stderr);
+		return EXIT_FAILURE;
+	}
+
+	if (!CheckTrackedFloatSum())
+	{
+		amxstub::Shutdown();
+		return EXIT_FAILURE;
+	}
+
+	printf("Scan kernels: %s\n", simd::GetLevelName(simd::GetLevel()));
+	printf("%-36s %8s %12s %12s\n", "native", "size", "ns/op", "allocs/op");
+	for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s)
+		RunCases(SIZES[s]);
+
+	int num_natives;
+	const AMX_NATIVE_INFO *natives = amxstub::GetNatives(num_natives);
+	int status = EXIT_SUCCESS;
+	for (int i = 0; i < num_natives; ++i)
+		if (measured.count(natives[i].name) == 0)
+		{
+			fprintf(stderr, "No benchmark for %s.\n", natives[i].name);
+			status = EXIT_FAILURE;
+		}
+	amxstub::Shutdown();
+	return status;
+}
@@ -0,0 +1,156 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "denseheap.h"
+
+
+void DenseHeap::SiftUp(size_t heap_index)
+{
+	const uint32_t entry = heap[heap_index];
+	while (heap_index > 0)
+	{
+		const size_t parent = (heap_index - 1) / 2;
+		if (!Before(entry, heap[parent]))
+			break;
+		Place(heap_index, heap[parent]);
+		heap_index = parent;
+	}
+	Place(heap_index, entry);
+}
+
+void DenseHeap::SiftDown(size_t heap_index)
+{
+	const uint32_t entry = heap[heap_index];
+	const size_t size = heap.size();
+	for (;;)
+	{
+		size_t child = 2 * heap_index + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && Before(heap[child + 1], heap[child]))
+			++child;
+		if (!Before(heap[child], entry))
+			break;
+		Place(heap_index, heap[child]);
+		heap_index = child;
+	}
+	Place(heap_index, entry);
+}
+
+bool DenseHeap::PriorityOf(int value, int &priority) const
+{
+	const int entry = values.IndexOf(value);
+	if (entry == -1)
+		return false;
+	priority = priorities[entry];
+	return true;
+}
+
+bool DenseHeap::Push(int value, int priority)
+{
+	const int entry = values.IndexOf(value);
+	if (entry != -1)
+	{
+		const int old_priority = priorities[entry];
+		priorities[entry] = priority;
+		if (priority < old_priority)
+			SiftUp(heap_index_of[entry]);
+		else if (priority > old_priority)
+			SiftDown(heap_index_of[entry]);
+		return false;
+	}
+	const uint32_t added = static_cast<uint32_t>(values.Size());
+	values.Insert(value);
+	priorities.push_back(priority);
+	heap_index_of.push_back(static_cast<uint32_t>(heap.size()));
+	heap.push_back(added);
+	SiftUp(heap.size() - 1);
+	return true;
+}
+
+bool DenseHeap::DecreaseKey(int value, int priority)
+{
+	const int entry = values.IndexOf(value);
+	if (entry == -1 || priority >= priorities[entry])
+		return false;
+	priorities[entry] = priority;
+	SiftUp(heap_index_of[entry]);
+	return true;
+}
+
+bool DenseHeap::Erase(int value)
+{
+	const int entry = values.IndexOf(value);
+	if (entry == -1)
+		return false;
+	EraseAt(static_cast<uint32_t>(entry));
+	return true;
+}
+
+void DenseHeap::EraseAt(uint32_t entry)
+{
+	// Take the entry out of the heap, the last one of the heap fills the hole.
+	const size_t hole = heap_index_of[entry];
+	const uint32_t moved = heap.back();
+	heap.pop_back();
+	if (hole < heap.size())
+	{
+		Place(hole, moved);
+		if (hole > 0 && Before(moved, heap[(hole - 1) / 2]))
+			SiftUp(hole);
+		else
+			SiftDown(hole);
+	}
+
+	// The set moves its last value into the entry, the arrays follow.
+	values.EraseAt(entry);
+	const uint32_t last = static_cast<uint32_t>(priorities.size() - 1);
+	if (entry != last)
+	{
+		priorities[entry] = priorities[last];
+		Place(heap_index_of[last], entry);
+	}
+	priorities.pop_back();
+	heap_index_of.pop_back();
+}
+
+void DenseHeap::Clear()
+{
+	values.Clear();
+	priorities.clear();
+	heap_index_of.clear();
+	heap.clear();
+}
+
+void DenseHeap::Swap(DenseHeap &other)
+{
+	values.Swap(other.values);
+	priorities.swap(other.priorities);
+	heap_index_of.swap(other.heap_index_of);
+	heap.swap(other.heap);
+}
+
+size_t DenseHeap::MemoryUsage() const
+{
+	return values.MemoryUsage() + priorities.capacity() * sizeof(int) +
+		(heap_index_of.capacity() + heap.capacity()) * sizeof(uint32_t);
+}
@@ -0,0 +1,116 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _DENSEHEAP_H
+#define _DENSEHEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "denseset.h"
+#include "pool.h"
+
+
+/*
+	Storage engine of a priority queue: a binary min-heap of unique values
+	ordered by an int priority. The values are a DenseSet, which finds a
+	value's position in O(1) for decrease-key and removal. The heap itself
+	orders those positions, and every position records where it sits in
+	the heap, so sifting moves plain ints without touching the index.
+
+	Push, pop, removal and priority changes are O(log n), peek is O(1).
+	Values of equal priority come out in no particular order.
+*/
+class DenseHeap
+{
+public:
+	size_t Size() const { return values.Size(); }
+	bool Empty() const { return values.Empty(); }
+	bool Contains(int value) const { return values.Contains(value); }
+
+	/*
+		Returns the value of lowest priority and its priority. The heap must
+		not be empty.
+	*/
+	int Top() const { return values.At(heap[0]); }
+	int TopPriority() const { return priorities[heap[0]]; }
+
+	/*
+		Finds the priority of a value. Returns false if it isn't queued.
+	*/
+	bool PriorityOf(int value, int &priority) const;
+
+	/*
+		Queues the value, or changes its priority if it's already queued.
+		Returns true if the value is new.
+	*/
+	bool Push(int value, int priority);
+
+	/*
+		Removes the value of lowest priority. The heap must not be empty.
+	*/
+	void Pop() { EraseAt(heap[0]); }
+
+	/*
+		Lowers the priority of a queued value. Returns false if the value
+		isn't queued or the priority isn't lower.
+	*/
+	bool DecreaseKey(int value, int priority);
+
+	/*
+		Removes the value. Returns false if it isn't queued.
+	*/
+	bool Erase(int value);
+
+	/*
+		Removes all values, keeping the allocated capacity.
+	*/
+	void Clear();
+
+	/*
+		Exchanges the contents with another heap.
+	*/
+	void Swap(DenseHeap &other);
+
+	/*
+		Returns the number of bytes allocated on the heap for the values.
+	*/
+	size_t MemoryUsage() const;
+
+private:
+	typedef std::vector<uint32_t, pool::Allocator<uint32_t> > PositionArray;
+
+	bool Before(uint32_t a, uint32_t b) const { return priorities[a] < priorities[b]; }
+	void Place(size_t heap_index, uint32_t entry) { heap[heap_index] = entry; heap_index_of[entry] = static_cast<uint32_t>(heap_index); }
+	void SiftUp(size_t heap_index);
+	void SiftDown(size_t heap_index);
+	void EraseAt(uint32_t entry);
+
+	// The entries are the positions of the values in the set.
+	DenseSet values;
+	std::vector<int, pool::Allocator<int> > priorities; // by entry
+	PositionArray heap_index_of; // by entry
+	PositionArray heap; // the entries in heap order
+};
+
+
+#endif // _DENSEHEAP_H
@@ -0,0 +1,121 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include "densemap.h"
+
+
+size_t DenseMap::Emplace(int key, bool &added)
+{
+	const int index = keys.IndexOf(key);
+	if (index != -1)
+	{
+		added = false;
+		return static_cast<size_t>(index);
+	}
+	keys.Insert(key);
+	values.push_back(0);
+	if (!arrays.empty())
+		arrays.push_back(ArrayValue());
+	added = true;
+	return values.size() - 1;
+}
+
+bool DenseMap::Set(int key, int value)
+{
+	bool added;
+	const size_t index = Emplace(key, added);
+	values[index] = value;
+	if (index < arrays.size())
+		ArrayValue().swap(arrays[index]);
+	return added;
+}
+
+bool DenseMap::SetArray(int key, const int *first, size_t count)
+{
+	bool added;
+	const size_t index = Emplace(key, added);
+	values[index] = static_cast<int>(count);
+	if (count == 0)
+	{
+		if (index < arrays.size())
+			ArrayValue().swap(arrays[index]);
+		return added;
+	}
+	if (arrays.empty())
+		arrays.resize(values.size());
+	arrays[index].assign(first, first + count);
+	return added;
+}
+
+bool DenseMap::Erase(int key)
+{
+	const int index = keys.IndexOf(key);
+	if (index == -1)
+		return false;
+	EraseAt(static_cast<size_t>(index));
+	return true;
+}
+
+void DenseMap::EraseAt(size_t index)
+{ // The keys move the last entry into the hole, the values follow.
+	keys.EraseAt(index);
+	const size_t last = values.size() - 1;
+	values[index] = values[last];
+	values.pop_back();
+	if (!arrays.empty())
+	{
+		arrays[index].swap(arrays[last]);
+		arrays.pop_back();
+	}
+}
+
+void DenseMap::Reserve(size_t count)
+{
+	keys.Reserve(count);
+	values.reserve(count);
+	if (!arrays.empty())
+		arrays.reserve(count);
+}
+
+void DenseMap::Clear()
+{
+	keys.Clear();
+	values.clear();
+	// Drops the arrays along with their storage.
+	std::vector<ArrayValue, pool::Allocator<ArrayValue> >().swap(arrays);
+}
+
+void DenseMap::Swap(DenseMap &other)
+{
+	keys.Swap(other.keys);
+	values.swap(other.values);
+	arrays.swap(other.arrays);
+}
+
+size_t DenseMap::MemoryUsage() const
+{
+	size_t bytes = keys.MemoryUsage() + (values.IsInline() ? 0 : values.capacity() * sizeof(int));
+	bytes += arrays.capacity() * sizeof(ArrayValue);
+	for (size_t i = 0; i < arrays.size(); ++i)
+		bytes += arrays[i].capacity() * sizeof(int);
+	return bytes;
+}
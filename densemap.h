@@ -0,0 +1,122 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _DENSEMAP_H
+#define _DENSEMAP_H
+
+#include <cstddef>
+#include <vector>
+#include "denseset.h"
+#include "pool.h"
+#include "smallarray.h"
+
+
+/*
+	Storage engine of a map: the keys are a DenseSet and the values a dense
+	array kept in step with it, so a key and its value share a position.
+	Lookups go through the open-addressing index of the keys and removals
+	move the last entry into the hole, iterating by position visits every
+	entry once.
+
+	A value is an int, or an array of ints. The arrays live in a third
+	array which is only allocated once the map holds one; the int value of
+	an array entry is its length.
+*/
+class DenseMap
+{
+public:
+	size_t Size() const { return keys.Size(); }
+	bool Empty() const { return keys.Empty(); }
+	int KeyAt(size_t index) const { return keys.At(index); }
+	int ValueAt(size_t index) const { return values[index]; }
+
+	/*
+		Returns the position of the key, or -1 if it isn't stored.
+	*/
+	int IndexOf(int key) const { return keys.IndexOf(key); }
+
+	/*
+		Returns the array stored at the given position, or NULL if the entry
+		holds an int.
+	*/
+	const int *ArrayAt(size_t index) const
+	{
+		return (index < arrays.size() && !arrays[index].empty()) ? arrays[index].data() : NULL;
+	}
+
+	/*
+		Sets the value of the key, replacing an array. Returns true if the
+		key is new.
+	*/
+	bool Set(int key, int value);
+
+	/*
+		Sets the array of the key, an empty array is stored as the int 0.
+		Returns true if the key is new.
+	*/
+	bool SetArray(int key, const int *first, size_t count);
+
+	/*
+		Removes the key by moving the last entry into its place. Returns
+		false if the key isn't stored.
+	*/
+	bool Erase(int key);
+
+	/*
+		Removes the entry at the given position, which must be valid.
+	*/
+	void EraseAt(size_t index);
+
+	/*
+		Makes room for the given number of entries.
+	*/
+	void Reserve(size_t count);
+
+	/*
+		Removes all entries, keeping the allocated capacity of the keys and
+		int values.
+	*/
+	void Clear();
+
+	/*
+		Exchanges the contents with another map.
+	*/
+	void Swap(DenseMap &other);
+
+	/*
+		Returns the number of bytes allocated on the heap for the entries.
+	*/
+	size_t MemoryUsage() const;
+
+private:
+	typedef std::vector<int, pool::Allocator<int> > ArrayValue;
+
+	// Returns the position of the key, adding it with the value 0 if it's new.
+	size_t Emplace(int key, bool &added);
+
+	DenseSet keys;
+	SmallArray<int, DenseSet::SMALL_SIZE> values;
+	std::vector<ArrayValue, pool::Allocator<ArrayValue> > arrays;
+};
+
+
+#endif // _DENSEMAP_H
@@ -0,0 +1,388 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "denseset.h"
+
+
+// Out-of-line definition, std::min() and friends bind it to a reference.
+const size_t DenseSet::SMALL_SIZE;
+
+static const size_t MIN_INDEX_CAPACITY = 16;
+
+// The smallest index keeping the given number of values at most 3/4 full.
+static size_t IndexCapacityFor(size_t count)
+{
+	size_t capacity = MIN_INDEX_CAPACITY;
+	while (count * 4 > capacity * 3)
+		capacity *= 2;
+	return capacity;
+}
+
+DenseSet::DenseSet(bool ordered, ElementType type) :
+	mask(0), shift(32), ordered(ordered), type(type), tracking(false), extremes_stale(false), sum(0), float_sum(0.0), float_sum_error(0.0), smallest(0), largest(0)
+{
+}
+
+size_t DenseSet::CountInRange(int lo, int hi) const
+{
+	if (lo > hi)
+		return 0;
+	if (ordered)
+		return UpperBound(hi) - LowerBound(lo);
+	return simd::CountInRange(values.data(), values.size(), lo, hi);
+}
+
+bool DenseSet::MinMax(int &min, int &max) const
+{
+	if (values.empty())
+		return false;
+	if (ordered)
+	{
+		min = values.front();
+		max = values.back();
+		return true;
+	}
+	if (!tracking)
+	{
+		simd::MinMax(values.data(), values.size(), min, max);
+		return true;
+	}
+	if (extremes_stale)
+	{
+		simd::MinMax(values.data(), values.size(), smallest, largest);
+		extremes_stale = false;
+	}
+	min = smallest;
+	max = largest;
+	return true;
+}
+
+void DenseSet::TrackAggregates(bool enable)
+{
+	tracking = false;
+	if (enable)
+	{
+		if (type == ELEMENT_FLOAT)
+		{
+			float_sum = FloatSum();
+			float_sum_error = 0.0;
+		}
+		else
+			sum = Sum();
+		extremes_stale = true;
+		tracking = true;
+	}
+}
+
+void DenseSet::AddToSum(int value, int sign)
+{
+	if (type == ELEMENT_FLOAT)
+	{
+		const int bits = simd::FloatKey(value);
+		float number;
+		memcpy(&number, &bits, sizeof(number));
+		const double addend = sign * static_cast<double>(number);
+		const double total = float_sum + addend;
+		// Keeps the low-order bits lost by the addition, whichever operand they came from.
+		if (std::fabs(float_sum) >= std::fabs(addend))
+			float_sum_error += (float_sum - total) + addend;
+		else
+			float_sum_error += (addend - total) + float_sum;
+		float_sum = total;
+	}
+	else
+		sum += sign * static_cast<int64_t>(value);
+}
+
+void DenseSet::Added(int value)
+{ // Called after the value is stored.
+	AddToSum(value, 1);
+	if (values.size() == 1)
+	{
+		smallest = largest = value;
+		extremes_stale = false;
+	}
+	else if (!extremes_stale)
+	{
+		if (value < smallest)
+			smallest = value;
+		if (value > largest)
+			largest = value;
+	}
+}
+
+void DenseSet::Removed(int value)
+{
+	AddToSum(value, -1);
+	if (value == smallest || value == largest)
+		extremes_stale = true;
+}
+
+size_t DenseSet::FindSlot(int value) const
+{
+	for (size_t i = Home(value); ; i = (i + 1) & mask)
+		if (slots[i].value == value && slots[i].pos != EMPTY_SLOT)
+			return i;
+}
+
+void DenseSet::InsertSlot(int value, uint32_t pos)
+{
+	size_t i = Home(value);
+	while (slots[i].pos != EMPTY_SLOT)
+		i = (i + 1) & mask;
+	slots[i].value = value;
+	slots[i].pos = pos;
+}
+
+void DenseSet::RemoveSlot(size_t slot_index)
+{ // Backward shift deletion, keeps the probe sequences intact without tombstones.
+	size_t hole = slot_index;
+	for (size_t i = (hole + 1) & mask; slots[i].pos != EMPTY_SLOT; i = (i + 1) & mask)
+	{
+		const size_t home = Home(slots[i].value);
+		// Move the entry into the hole only if its home isn't cyclically in (hole, i].
+		if (((i - home) & mask) >= ((i - hole) & mask))
+		{
+			slots[hole] = slots[i];
+			hole = i;
+		}
+	}
+	slots[hole].pos = EMPTY_SLOT;
+}
+
+void DenseSet::UpdatePositions(size_t first)
+{
+	if (slots.empty())
+		return;
+	for (size_t i = first; i < values.size(); ++i)
+		slots[FindSlot(values[i])].pos = static_cast<uint32_t>(i);
+}
+
+void DenseSet::Rehash(size_t capacity)
+{
+	size_t bits = 0;
+	while ((static_cast<size_t>(1) << bits) < capacity)
+		++bits;
+	Slot empty;
+	empty.value = 0;
+	empty.pos = EMPTY_SLOT;
+	// A new buffer rather than assign(), so that shrinking releases the old one.
+	SlotArray(static_cast<size_t>(1) << bits, empty).swap(slots);
+	mask = slots.size() - 1;
+	shift = 32 - static_cast<unsigned int>(bits);
+	for (size_t i = 0; i < values.size(); ++i)
+		InsertSlot(values[i], static_cast<uint32_t>(i));
+}
+
+bool DenseSet::Insert(int value)
+{
+	if (ordered)
+	{
+		const size_t index = LowerBound(value);
+		if (index < values.size() && values[index] == value)
+			return false;
+		values.insert(values.begin() + index, value);
+		if (tracking)
+			Added(value);
+		return true;
+	}
+	if (IndexOf(value) != -1)
+		return false;
+	if (slots.empty() && values.size() < SMALL_SIZE)
+	{
+		values.push_back(value);
+		if (tracking)
+			Added(value);
+		return true;
+	}
+	// The index is never allowed to be more than 3/4 full.
+	if ((values.size() + 1) * 4 > slots.size() * 3)
+		Rehash(IndexCapacityFor(values.size() + 1));
+	InsertSlot(value, static_cast<uint32_t>(values.size()));
+	values.push_back(value);
+	if (tracking)
+		Added(value);
+	return true;
+}
+
+size_t DenseSet::Append(const int *first, size_t count)
+{
+	const size_t old_size = values.size();
+	// Grows geometrically, appending a few values at a time stays amortized O(1).
+	const size_t needed = old_size + count;
+	Reserve(needed > values.capacity() ? std::max(needed, 2 * values.capacity()) : needed);
+	if (ordered)
+	{ // Sort the new values on their own, then merge them with the old ones.
+		values.insert(values.end(), first, first + count);
+		std::sort(values.begin() + old_size, values.end());
+		std::inplace_merge(values.begin(), values.begin() + old_size, values.end());
+		values.erase(std::unique(values.begin(), values.end()), values.end());
+		if (tracking)
+			TrackAggregates(true);
+		return values.size() - old_size;
+	}
+	for (const int *last = first + count; first != last; ++first)
+		if (IndexOf(*first) == -1)
+		{
+			if (!slots.empty())
+				InsertSlot(*first, static_cast<uint32_t>(values.size()));
+			values.push_back(*first);
+			if (tracking)
+				Added(*first);
+		}
+	return values.size() - old_size;
+}
+
+size_t DenseSet::Assign(const int *first, size_t count)
+{
+	Clear();
+	return Append(first, count);
+}
+
+void DenseSet::Reserve(size_t count)
+{
+	if (count > values.capacity())
+		values.reserve(count);
+	if (ordered || (slots.empty() && count <= SMALL_SIZE))
+		return;
+	if (count * 4 > slots.size() * 3)
+		Rehash(IndexCapacityFor(count));
+}
+
+void DenseSet::ShrinkToFit()
+{
+	values.shrink_to_fit();
+	if (ordered)
+		return;
+	if (values.size() <= SMALL_SIZE)
+	{ // Back to linear scans.
+		SlotArray().swap(slots);
+		mask = 0;
+		shift = 32;
+		return;
+	}
+	const size_t capacity = IndexCapacityFor(values.size());
+	if (capacity < slots.size())
+		Rehash(capacity);
+}
+
+bool DenseSet::Erase(int value)
+{
+	const int index = IndexOf(value);
+	if (index == -1)
+		return false;
+	EraseAt(static_cast<size_t>(index));
+	return true;
+}
+
+void DenseSet::EraseAt(size_t index)
+{
+	if (tracking)
+		Removed(values[index]);
+	if (ordered)
+	{
+		values.erase(values.begin() + index);
+		return;
+	}
+	if (!slots.empty())
+		RemoveSlot(FindSlot(values[index]));
+	const size_t last = values.size() - 1;
+	if (index != last)
+	{
+		const int moved = values[last];
+		if (!slots.empty())
+			slots[FindSlot(moved)].pos = static_cast<uint32_t>(index);
+		values[index] = moved;
+	}
+	values.pop_back();
+}
+
+void DenseSet::EraseAtOrdered(size_t index)
+{
+	if (tracking)
+		Removed(values[index]);
+	if (ordered)
+	{
+		values.erase(values.begin() + index);
+		return;
+	}
+	if (!slots.empty())
+		RemoveSlot(FindSlot(values[index]));
+	values.erase(values.begin() + index);
+	UpdatePositions(index);
+}
+
+bool DenseSet::ReplaceAt(size_t index, int value)
+{
+	const int current = IndexOf(value);
+	if (current != -1)
+		return static_cast<size_t>(current) == index;
+	if (tracking)
+	{ // Account for the old value first: the new one may become the only extreme.
+		Removed(values[index]);
+		Added(value);
+	}
+	if (ordered)
+	{
+		values.erase(values.begin() + index);
+		values.insert(values.begin() + LowerBound(value), value);
+		return true;
+	}
+	if (!slots.empty())
+	{
+		RemoveSlot(FindSlot(values[index]));
+		InsertSlot(value, static_cast<uint32_t>(index));
+	}
+	values[index] = value;
+	return true;
+}
+
+void DenseSet::Clear()
+{
+	values.clear();
+	sum = 0;
+	float_sum = 0.0;
+	float_sum_error = 0.0;
+	extremes_stale = false;
+	for (size_t i = 0; i < slots.size(); ++i)
+		slots[i].pos = EMPTY_SLOT;
+}
+
+void DenseSet::Swap(DenseSet &other)
+{
+	values.swap(other.values);
+	slots.swap(other.slots);
+	std::swap(mask, other.mask);
+	std::swap(shift, other.shift);
+	std::swap(ordered, other.ordered);
+	std::swap(type, other.type);
+	std::swap(tracking, other.tracking);
+	std::swap(extremes_stale, other.extremes_stale);
+	std::swap(sum, other.sum);
+	std::swap(float_sum, other.float_sum);
+	std::swap(float_sum_error, other.float_sum_error);
+	std::swap(smallest, other.smallest);
+	std::swap(largest, other.largest);
+}
@@ -0,0 +1,296 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _DENSESET_H
+#define _DENSESET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "pool.h"
+#include "simd.h"
+#include "smallarray.h"
+
+
+/*
+	Storage engine of a vector: a dense array of unique values plus an
+	open-addressing (linear probing) index mapping every value to its slot
+	in the dense array. Both are kept in step by every mutation, so add,
+	contains, index-of and swap-remove are all O(1).
+
+	An ordered set keeps the dense array sorted in ascending order instead
+	and doesn't build the index: lookups are binary searches and insertions
+	and removals shift the tail of the array.
+
+	Up to SMALL_SIZE values are stored inside the set itself and found by a
+	SIMD linear scan, the index is only built once the set grows past that.
+	Most vectors are tiny and never pay for an allocation or a hash lookup.
+	The threshold comes from the 'small' cases of the benchmark: with the
+	AVX2 kernel a scan beats a probe of the index up to about 8 to 16
+	values, a probe wins clearly beyond.
+	Larger arrays are allocated from the plugin-wide pool.
+
+	The elements are ints, Floats or strings. A Float is stored as its
+	FloatKey(), which orders like the Float, so sorting, the sorted mode,
+	range queries and min/max treat both types alike; only the sum differs.
+	A string is stored as its ID in the string pool. Callers convert with
+	ToKey() and ToValue() at the boundary.
+*/
+class DenseSet
+{
+public:
+	static const size_t SMALL_SIZE = 8;
+
+	enum ElementType
+	{
+		ELEMENT_INT,
+		ELEMENT_FLOAT,
+		ELEMENT_STRING
+	};
+
+	explicit DenseSet(bool ordered = false, ElementType type = ELEMENT_INT);
+
+	bool IsOrdered() const { return ordered; }
+	ElementType Type() const { return type; }
+
+	/*
+		Converts between the bits of a value and the key stored for it.
+	*/
+	int ToKey(int value) const { return type == ELEMENT_FLOAT ? simd::FloatKey(value) : value; }
+	int ToValue(int key) const { return type == ELEMENT_FLOAT ? simd::FloatKey(key) : key; }
+	size_t Size() const { return values.size(); }
+	bool Empty() const { return values.empty(); }
+	const int *Data() const { return values.data(); }
+	int At(size_t index) const { return values[index]; }
+	int Front() const { return values.front(); }
+	int Back() const { return values.back(); }
+
+	/*
+		Returns the position of the value in the dense array, or -1 if the
+		value isn't stored.
+	*/
+	int IndexOf(int value) const
+	{
+		if (ordered)
+		{
+			const size_t index = LowerBound(value);
+			return (index < values.size() && values[index] == value) ? static_cast<int>(index) : -1;
+		}
+		if (slots.empty())
+			return simd::Find(values.data(), values.size(), value);
+		for (size_t i = Home(value); ; i = (i + 1) & mask)
+		{
+			const Slot &slot = slots[i];
+			if (slot.pos == EMPTY_SLOT)
+				return -1;
+			if (slot.value == value)
+				return static_cast<int>(slot.pos);
+		}
+	}
+
+	bool Contains(int value) const { return IndexOf(value) != -1; }
+
+	/*
+		Returns the position of the first element not less than / greater
+		than the value. Only meaningful for ordered sets.
+	*/
+	size_t LowerBound(int value) const
+	{
+		return static_cast<size_t>(std::lower_bound(values.begin(), values.end(), value) - values.begin());
+	}
+	size_t UpperBound(int value) const
+	{
+		return static_cast<size_t>(std::upper_bound(values.begin(), values.end(), value) - values.begin());
+	}
+
+	/*
+		Counts the elements in the range [lo, hi].
+	*/
+	size_t CountInRange(int lo, int hi) const;
+
+	/*
+		Adds up the elements in 64 bits.
+	*/
+	int64_t Sum() const { return tracking ? sum : simd::Sum(values.data(), values.size()); }
+
+	/*
+		Adds up the elements of a Float set in double precision.
+	*/
+	double FloatSum() const { return tracking ? float_sum + float_sum_error : simd::SumFloatKeys(values.data(), values.size()); }
+
+	/*
+		Finds the smallest and the largest element. Returns false if the set
+		is empty.
+	*/
+	bool MinMax(int &min, int &max) const;
+
+	/*
+		Keeps the sum, minimum and maximum up to date on every mutation, so
+		Sum() and MinMax() don't scan the elements. Removing the current
+		minimum or maximum only marks them stale, they're found again by a
+		single scan on the next read. The Float sum is compensated, so
+		removing a large value doesn't leave the error of the smaller ones
+		behind.
+	*/
+	void TrackAggregates(bool enable);
+	bool IsTrackingAggregates() const { return tracking; }
+
+	/*
+		Appends the value. Returns false if it's already stored.
+	*/
+	bool Insert(int value);
+
+	/*
+		Appends the values that aren't already stored, growing the storage
+		at most once. Returns the number of values added.
+	*/
+	size_t Append(const int *first, size_t count);
+
+	/*
+		Replaces the contents with the given values, duplicates are skipped.
+		Returns the number of values stored.
+	*/
+	size_t Assign(const int *first, size_t count);
+
+	/*
+		Makes room for the given number of elements in both the dense array
+		and the index.
+	*/
+	void Reserve(size_t count);
+
+	/*
+		Returns the number of elements the set can hold without growing.
+	*/
+	size_t Capacity() const { return values.capacity(); }
+
+	/*
+		Releases the capacity not needed by the current elements, the index
+		is shrunk to the smallest size keeping it at most 3/4 full, or
+		dropped along with moving the values inside the set if they fit.
+	*/
+	void ShrinkToFit();
+
+	/*
+		Returns the number of bytes allocated on the heap by the dense array
+		and the index.
+	*/
+	size_t MemoryUsage() const
+	{
+		return (values.IsInline() ? 0 : values.capacity() * sizeof(int)) + slots.capacity() * sizeof(Slot);
+	}
+
+	/*
+		Removes the value by moving the last element into its place.
+		Returns false if the value isn't stored.
+	*/
+	bool Erase(int value);
+
+	/*
+		Removes the element at the given position by moving the last element
+		into its place (ordered sets shift the tail instead). The position
+		must be valid.
+	*/
+	void EraseAt(size_t index);
+
+	/*
+		Removes the element at the given position keeping the order of the
+		remaining elements (O(n)). The position must be valid.
+	*/
+	void EraseAtOrdered(size_t index);
+
+	/*
+		Overwrites the element at the given position, an ordered set moves the
+		new value to its sorted position. Returns false if the new value is
+		already stored at another position.
+	*/
+	bool ReplaceAt(size_t index, int value);
+
+	/*
+		Sorts the elements with the given comparison, elements which compare
+		equal keep their relative order. Ordered sets can't be reordered,
+		returns false for them.
+	*/
+	template <typename Compare>
+	bool Sort(Compare compare)
+	{
+		if (ordered)
+			return false;
+		std::stable_sort(values.begin(), values.end(), compare);
+		UpdatePositions(0);
+		return true;
+	}
+
+	/*
+		Removes all elements, keeping the allocated capacity.
+	*/
+	void Clear();
+
+	/*
+		Exchanges the contents with another set.
+	*/
+	void Swap(DenseSet &other);
+
+private:
+	struct Slot
+	{
+		int value;
+		uint32_t pos;
+	};
+
+	static const uint32_t EMPTY_SLOT = 0xFFFFFFFFu;
+
+	size_t Home(int value) const
+	{ // Fibonacci hashing, the high bits are the best mixed ones.
+		return static_cast<size_t>((static_cast<uint32_t>(value) * 2654435769u) >> shift) & mask;
+	}
+
+	size_t FindSlot(int value) const;
+	void InsertSlot(int value, uint32_t pos);
+	void RemoveSlot(size_t slot_index);
+	void UpdatePositions(size_t first);
+	void Rehash(size_t capacity);
+	void AddToSum(int value, int sign);
+	void Added(int value);
+	void Removed(int value);
+
+	typedef SmallArray<int, SMALL_SIZE> ValueArray;
+	typedef std::vector<Slot, pool::Allocator<Slot> > SlotArray;
+
+	ValueArray values;
+	SlotArray slots;
+	size_t mask;
+	unsigned int shift;
+	bool ordered;
+	ElementType type;
+
+	// Aggregates, only maintained while tracking.
+	bool tracking;
+	mutable bool extremes_stale;
+	int64_t sum;
+	double float_sum;
+	double float_sum_error; // Neumaier compensation of float_sum.
+	mutable int smallest, largest;
+};
+
+
+#endif // _DENSESET_H
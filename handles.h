@@ -0,0 +1,149 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _HANDLES_H
+#define _HANDLES_H
+
+#include <cstddef>
+#include <vector>
+#include "SDK/amx/amx.h"
+
+
+/*
+	A handle holds the slot of its object in the low bits and the generation
+	of the slot in the high bits. The generation is bumped every time an
+	object is destroyed, so a stale handle is rejected instead of pointing to
+	whatever object reuses the slot. Handle 0 is never valid.
+
+	A slot serves at most HANDLE_GENERATION_MASK + 1 (2048) objects: once
+	its generation would wrap it's retired instead of reused, otherwise a
+	stale handle would become valid again. Up to HANDLE_SLOT_MASK objects
+	exist at once, and about 2^31 can be created over the plugin's
+	lifetime before Create() runs out of slots.
+*/
+const unsigned int HANDLE_SLOT_BITS = 20;
+const ucell HANDLE_SLOT_MASK = (1u << HANDLE_SLOT_BITS) - 1;
+const unsigned int HANDLE_GENERATION_MASK = 0x7FF;
+
+/*
+	The objects of one kind referenced by script handles. Destroyed slots are
+	reused, the object type needs a default constructor and a Swap().
+*/
+template <typename T>
+class HandleTable
+{
+public:
+	struct Slot
+	{
+		T data;
+		AMX *owner; // NULL for objects not owned by a script
+		unsigned int generation;
+		bool in_use;
+	};
+
+	/*
+		Returns the object of the handle, or NULL if the handle is invalid or
+		stale.
+	*/
+	T *Get(cell handle)
+	{
+		const size_t slot = SlotOf(handle);
+		if (handle <= 0 || slot >= slots.size())
+			return NULL;
+		Slot &entry = slots[slot];
+		if (!entry.in_use || entry.generation != (static_cast<ucell>(handle) >> HANDLE_SLOT_BITS))
+			return NULL;
+		return &entry.data;
+	}
+
+	/*
+		Takes a slot for a new object, swapping the given one in. Returns the
+		handle, or 0 if no slot is left.
+	*/
+	cell Create(AMX *owner, T &object)
+	{
+		size_t slot;
+		if (!free_slots.empty())
+		{
+			slot = free_slots.back();
+			free_slots.pop_back();
+		}
+		else
+		{
+			if (slots.size() >= HANDLE_SLOT_MASK)
+				return 0;
+			slot = slots.size();
+			slots.push_back(Slot());
+			slots[slot].generation = 0;
+		}
+		object.Swap(slots[slot].data);
+		slots[slot].owner = owner;
+		slots[slot].in_use = true;
+		return HandleOf(slot);
+	}
+
+	/*
+		Frees the object in the slot, the slot must be in use. The slot is
+		retired if its generation is exhausted.
+	*/
+	void Destroy(size_t slot)
+	{
+		Slot &entry = slots[slot];
+		T().Swap(entry.data);
+		entry.owner = NULL;
+		entry.in_use = false;
+		if (entry.generation == HANDLE_GENERATION_MASK)
+			return;
+		++entry.generation;
+		free_slots.push_back(slot);
+	}
+
+	/*
+		Destroys every object owned by the script.
+	*/
+	void DestroyOwnedBy(AMX *amx)
+	{
+		for (size_t slot = 0; slot < slots.size(); ++slot)
+			if (slots[slot].in_use && slots[slot].owner == amx)
+				Destroy(slot);
+	}
+
+	static size_t SlotOf(cell handle) { return static_cast<size_t>(static_cast<ucell>(handle) & HANDLE_SLOT_MASK) - 1; }
+	cell HandleOf(size_t slot) const { return static_cast<cell>((slots[slot].generation << HANDLE_SLOT_BITS) | (slot + 1)); }
+
+	size_t Size() const { return slots.size(); }
+	Slot &operator[](size_t slot) { return slots[slot]; }
+	const Slot &operator[](size_t slot) const { return slots[slot]; }
+
+	/*
+		Returns the number of bytes taken by the slots, not counting what the
+		objects allocate themselves.
+	*/
+	size_t MemoryUsage() const { return slots.capacity() * sizeof(Slot) + free_slots.capacity() * sizeof(size_t); }
+
+private:
+	std::vector<Slot> slots;
+	std::vector<size_t> free_slots;
+};
+
+
+#endif // _HANDLES_H
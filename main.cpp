@@ -23,7 +23,12 @@
 
 
 #include <cstddef>
-#include <unordered_set>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <cassert>
 
@@ -31,32 +36,333 @@
 #include "SDK/plugincommon.h"
 #include "pluginconfig.h"
 #include "pluginutils.h"
+#include "denseset.h"
+#include "densemap.h"
+#include "denseheap.h"
+#include "handles.h"
+#include "recordtable.h"
+#include "pool.h"
+#include "stringpool.h"
+#include "tracing.h"
+#include "stats.h"
 
 
 extern void* pAMXFunctions;
 void* (*logprintf)(const char* fmt, ...);
 
 bool debugging = false;
-unsigned long int vctID = 0;
-std::vector<std::unordered_set<int>> vectors;
-std::vector<std::vector<int>> copy_vectors;
+
+/*
+	The object behind a vector handle: a set of values, or a table of
+	records when created by Vector_CreateRecords. The natives working on
+	values reject record vectors and the record natives reject the others,
+	Vector_Size, Vector_Empty, Vector_Clear, Vector_GetType and
+	Vector_Destroy take both.
+*/
+struct VectorObject
+{
+	DenseSet set;
+	RecordTable records;
+
+	bool HoldsRecords() const { return records.Fields() != 0; }
+	size_t Size() const { return HoldsRecords() ? records.Size() : set.Size(); }
+	bool Empty() const { return Size() == 0; }
+	void Clear() { set.Clear(); records.Clear(); }
+	size_t MemoryUsage() const { return set.MemoryUsage() + records.MemoryUsage(); }
+	void Swap(VectorObject &other) { set.Swap(other.set); records.Swap(other.records); }
+};
+
+// Vector_GetType of a record vector, after the element types of DenseSet.
+const cell VECTOR_RECORD_TYPE = 3;
+// Vector_CreateRecords refuses wider records.
+const cell MAX_RECORD_FIELDS = 1024;
+
+HandleTable<VectorObject> vectors;
+HandleTable<DenseMap> maps;
+HandleTable<DenseHeap> heaps;
+std::unordered_map<std::string, cell> shared_vectors;
+std::vector<int> set_operation_result;
+std::vector<int> batch_values;
+std::vector<int> converted_keys;
+
+/*
+	Operations of Vector_Batch, each one is packed as the opcode, the vector
+	handle and its operands.
+*/
+enum BatchOpcode
+{
+	BATCH_ADD = 1, // vector, value
+	BATCH_REMOVE = 2, // vector, value
+	BATCH_REPLACE = 3, // vector, old value, new value
+	BATCH_CLEAR = 4 // vector
+};
+
+// The number of cells taken by an operation, 0 for an unknown opcode.
+static size_t BatchOperationLength(cell opcode)
+{
+	switch (opcode) {
+	case BATCH_ADD:
+	case BATCH_REMOVE:
+		return 3;
+	case BATCH_REPLACE:
+		return 4;
+	case BATCH_CLEAR:
+		return 2;
+	}
+	return 0;
+}
+
+// Vector_Reserve refuses larger requests, a typo shouldn't take the server down.
+const cell MAX_RESERVE = 1 << 24;
+
+static cell ClampToCell(size_t value)
+{
+	const size_t max_cell = static_cast<size_t>(static_cast<ucell>(-1) >> 1);
+	return static_cast<cell>(value < max_cell ? value : max_cell);
+}
+
+// Same as amx_ftoc, without breaking the strict aliasing rules.
+static cell FloatToCell(float value)
+{
+	static_assert(sizeof(cell) == sizeof(float), "cell and float must have the same size");
+	cell result;
+	memcpy(&result, &value, sizeof(result));
+	return result;
+}
+
+static DenseSet *GetVector(cell handle)
+{
+	VectorObject *object = vectors.Get(handle);
+	return (object == NULL || object->HoldsRecords()) ? NULL : &object->set;
+}
+
+static RecordTable *GetRecords(cell handle)
+{
+	VectorObject *object = vectors.Get(handle);
+	return (object == NULL || !object->HoldsRecords()) ? NULL : &object->records;
+}
+
+static DenseMap *GetMap(cell handle)
+{
+	return maps.Get(handle);
+}
+
+static DenseHeap *GetHeap(cell handle)
+{
+	return heaps.Get(handle);
+}
+
+/*
+	The element type is the optional argument at the given position, scripts
+	compiled before it existed don't pass it. Logs an error for an unknown
+	type.
+*/
+static bool GetElementType(AMX *amx, const cell *params, int position, DenseSet::ElementType &type)
+{
+	const cell value = (static_cast<int>(params[0]) / static_cast<int>(sizeof(cell)) >= position) ? params[position] : 0;
+	if (value != DenseSet::ELEMENT_INT && value != DenseSet::ELEMENT_FLOAT && value != DenseSet::ELEMENT_STRING) {
+		logprintf("%s: %s: Unknown element type %d.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(value));
+		return false;
+	}
+	type = static_cast<DenseSet::ElementType>(value);
+	return true;
+}
+
+// Returns the keys of an array of values, only Float vectors need them converted.
+static const int *ToKeys(const DenseSet &vector, const cell *values, size_t count)
+{
+	if (vector.Type() == DenseSet::ELEMENT_INT)
+		return values;
+	converted_keys.resize(count);
+	for (size_t i = 0; i < count; ++i)
+		converted_keys[i] = vector.ToKey(values[i]);
+	return converted_keys.data();
+}
+
+// Strings no vector holds anymore are freed once the pool has doubled since the last collection.
+const size_t MIN_STRING_COLLECTION = 1024;
+size_t next_string_collection = MIN_STRING_COLLECTION;
+
+static void CollectStrings()
+{
+	std::vector<bool> live(stringpool::IdLimit());
+	for (size_t slot = 0; slot < vectors.Size(); ++slot) {
+		const DenseSet &vector = vectors[slot].data.set;
+		if (vectors[slot].in_use && vector.Type() == DenseSet::ELEMENT_STRING)
+			for (size_t i = 0; i < vector.Size(); ++i)
+				if (static_cast<unsigned int>(vector.At(i)) < live.size())
+					live[vector.At(i)] = true;
+	}
+	const size_t freed = stringpool::Collect(live);
+	next_string_collection = std::max(MIN_STRING_COLLECTION, 2 * stringpool::Count());
+	TRACE("Vector_AddString", "Freed %d unused strings, %d are left.", static_cast<int>(freed), static_cast<int>(stringpool::Count()));
+}
+
+static cell AddVector(AMX *amx, AMX *owner, VectorObject &object)
+{
+	const cell handle = vectors.Create(owner, object);
+	if (handle == 0)
+		logprintf("%s: %s: The limit of %d vectors has been reached.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(HANDLE_SLOT_MASK));
+	return handle;
+}
+
+static cell CreateVector(AMX *amx, AMX *owner, bool ordered, DenseSet::ElementType type)
+{
+	VectorObject object;
+	DenseSet(ordered, type).Swap(object.set);
+	return AddVector(amx, owner, object);
+}
+
+static size_t MemoryUsage()
+{
+	size_t bytes = vectors.MemoryUsage() + maps.MemoryUsage() + heaps.MemoryUsage() +
+		(set_operation_result.capacity() + batch_values.capacity() + converted_keys.capacity()) * sizeof(int);
+	for (size_t slot = 0; slot < vectors.Size(); ++slot)
+		bytes += vectors[slot].data.MemoryUsage();
+	for (size_t slot = 0; slot < maps.Size(); ++slot)
+		bytes += maps[slot].data.MemoryUsage();
+	for (size_t slot = 0; slot < heaps.Size(); ++slot)
+		bytes += heaps[slot].data.MemoryUsage();
+	bytes += stringpool::MemoryUsage();
+	// One node per name plus the bucket array.
+	bytes += shared_vectors.bucket_count() * sizeof(void *);
+	for (auto it = shared_vectors.begin(); it != shared_vectors.end(); ++it)
+		bytes += sizeof(*it) + 2 * sizeof(void *) + it->first.capacity() + 1;
+	return bytes;
+}
+
+static void DestroyVector(size_t slot)
+{
+	if (vectors[slot].owner == NULL) {
+		const cell handle = vectors.HandleOf(slot);
+		for (auto it = shared_vectors.begin(); it != shared_vectors.end(); ++it)
+			if (it->second == handle) {
+				shared_vectors.erase(it);
+				break;
+			}
+	}
+	vectors.Destroy(slot);
+}
 
 /// <summary>
-/// Creating the vector
+/// Creating the vector. The vector is destroyed when the script which created it is unloaded.
 /// </summary>
 /// <param name="amx"> Vector_Create </param>
-/// <param name="params"> none </param>
-/// <returns> vectorID </returns>
+/// <param name="params"> type </param>
+/// <returns> vectorID, or 0 if no more vectors can be created </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_Create(AMX* amx, cell* params)
 {
-	std::unordered_set<int> unordered_setts;
-	std::vector<int> copy_unordered_setts;
-	vectors.push_back(unordered_setts);
-	copy_vectors.push_back(copy_unordered_setts);
+	DenseSet::ElementType type;
+	if (!GetElementType(amx, params, 1, type))
+		return 0;
+	cell vectorID = CreateVector(amx, amx, false, type);
+	if (vectorID != 0) TRACE("Vector_Create", "A new vector has been created with ID: %d.", static_cast<int>(vectorID));
+	return vectorID;
+}
+
+/// <summary>
+/// Creating a vector which keeps its elements sorted in ascending order.
+/// Finding an index is O(log n), adding and removing elements keep the order.
+/// </summary>
+/// <param name="amx"> Vector_CreateSorted </param>
+/// <param name="params"> type </param>
+/// <returns> vectorID, or 0 if no more vectors can be created </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_CreateSorted(AMX* amx, cell* params)
+{
+	DenseSet::ElementType type;
+	if (!GetElementType(amx, params, 1, type))
+		return 0;
+	if (type == DenseSet::ELEMENT_STRING) {
+		logprintf("%s: %s: String vectors can't be sorted vectors, use Vector_Sort instead.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx));
+		return 0;
+	}
+	cell vectorID = CreateVector(amx, amx, true, type);
+	if (vectorID != 0) TRACE("Vector_CreateSorted", "A new sorted vector has been created with ID: %d.", static_cast<int>(vectorID));
+	return vectorID;
+}
+
+/// <summary>
+/// Creating a shared vector, which can be found by its name from every script
+/// and isn't destroyed when a script is unloaded.
+/// </summary>
+/// <param name="amx"> Vector_CreateShared </param>
+/// <param name="params"> const name[], type </param>
+/// <returns> vectorID of the existing vector with that name (whatever its type), or of a new one. 0 if no more vectors can be created </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_CreateShared(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet::ElementType type;
+	if (!GetElementType(amx, params, 2, type))
+		return 0;
+
+	int error;
+	std::string name = pluginutils::GetCXXString(amx, params[1], error);
+	if (error != AMX_ERR_NONE)
+		return 0;
+
+	auto it = shared_vectors.find(name);
+	if (it != shared_vectors.end()) {
+		TRACE("Vector_CreateShared", "Returning the existing shared vector \"%s\" with ID: %d.", name.c_str(), static_cast<int>(it->second));
+		return it->second;
+	}
+
+	cell vectorID = CreateVector(amx, NULL, false, type);
+	if (vectorID == 0)
+		return 0;
+	shared_vectors[name] = vectorID;
+	TRACE("Vector_CreateShared", "A new shared vector \"%s\" has been created with ID: %d.", name.c_str(), static_cast<int>(vectorID));
+	return vectorID;
+}
+
+/// <summary>
+/// Finding a shared vector by its name.
+/// </summary>
+/// <param name="amx"> Vector_FindShared </param>
+/// <param name="params"> const name[] </param>
+/// <returns> vectorID, or 0 if there is no shared vector with that name </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_FindShared(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	int error;
+	std::string name = pluginutils::GetCXXString(amx, params[1], error);
+	if (error != AMX_ERR_NONE)
+		return 0;
+
+	auto it = shared_vectors.find(name);
+	if (it == shared_vectors.end())
+		return 0;
+	TRACE("Vector_FindShared", "Returning the shared vector \"%s\" with ID: %d.", name.c_str(), static_cast<int>(it->second));
+	return it->second;
+}
+
+/// <summary>
+/// Destroys the vector and frees its memory. The vectorID becomes invalid.
+/// </summary>
+/// <param name="amx"> Vector_Destroy </param>
+/// <param name="params"> vectorID </param>
+/// <returns> 1 if vector has been destroyed, otherwise returns -1 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Destroy(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const VectorObject *vector = vectors.Get(params[1]);
+	if (vector == NULL)
+		return -1;
 
-	if(debugging) logprintf("%s: A new vector has been created with ID: %d.", pluginutils::GetCurrentNativeFunctionName(amx), vctID + 1);
-	return static_cast<cell>(++vctID);
+	TRACE("Vector_Destroy", "Destroying vector %d with %d elements.", static_cast<int>(params[1]), static_cast<int>(vector->Size()));
+	DestroyVector(HandleTable<VectorObject>::SlotOf(params[1]));
+	return 1;
 }
 
 /// <summary>
@@ -71,11 +377,117 @@ static cell AMX_NATIVE_CALL n_Vector_DebugMode(AMX* amx, cell* params) {
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
 
+#if defined DISABLE_TRACING
+	return logprintf("%s: The debugging mode isn't available, the plugin was built without tracing.", pluginutils::GetCurrentNativeFunctionName(amx)), 0;
+#else
 	if (debugging == static_cast<bool>(params[1]))
 		return logprintf("%s: The debugging mode is already %s.", pluginutils::GetCurrentNativeFunctionName(amx), debugging == true ? "enabled" : "disabled"), 1;
 	
 	debugging = static_cast<bool>(params[1]);
-	return logprintf("%s: The debugging mode has been %s.", pluginutils::GetCurrentNativeFunctionName(amx), debugging == true ? "enabled" : "disabled"), 1;
+	tracing::SetAll(debugging ? 1 : 0);
+	return logprintf("%s: The debugging mode has been %s, the output goes to \"%s\".", pluginutils::GetCurrentNativeFunctionName(amx), debugging == true ? "enabled" : "disabled", tracing::TRACE_FILE_NAME), 1;
+#endif
+}
+
+/// <summary>
+/// Toggles the tracing of a single native, optionally only one of every sample_rate calls.
+/// </summary>
+/// <param name="amx"> Vector_TraceNative </param>
+/// <param name="params"> const native[], toggle, sample_rate </param>
+/// <returns> 1, or 0 if the plugin was built without tracing </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_TraceNative(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+#if defined DISABLE_TRACING
+	return 0;
+#else
+	int error;
+	std::string native = pluginutils::GetCXXString(amx, params[1], error);
+	if (error != AMX_ERR_NONE)
+		return 0;
+
+	unsigned int sample_rate = params[3] > 0 ? static_cast<unsigned int>(params[3]) : 1;
+	tracing::SetNative(native, static_cast<bool>(params[2]) ? sample_rate : 0);
+	return 1;
+#endif
+}
+
+/// <summary>
+/// Retrieves the call count and the timings of a native, the times are in microseconds.
+/// </summary>
+/// <param name="amx"> Vector_GetStats </param>
+/// <param name="params"> const native[], &calls, &Float:total_time, &Float:max_time, &Float:p50_time, &Float:p99_time </param>
+/// <returns> 1 if the native exists, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_GetStats(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 6;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	int error;
+	std::string native = pluginutils::GetCXXString(amx, params[1], error);
+	if (error != AMX_ERR_NONE)
+		return 0;
+	const stats::NativeStats *entry = stats::Find(native.c_str());
+	if (entry == NULL)
+		return 0;
+
+	cell *calls, *total_time, *max_time, *p50_time, *p99_time;
+	if (amx_GetAddr(amx, params[2], &calls) != AMX_ERR_NONE || amx_GetAddr(amx, params[3], &total_time) != AMX_ERR_NONE ||
+		amx_GetAddr(amx, params[4], &max_time) != AMX_ERR_NONE || amx_GetAddr(amx, params[5], &p50_time) != AMX_ERR_NONE ||
+		amx_GetAddr(amx, params[6], &p99_time) != AMX_ERR_NONE)
+		return 0;
+
+	const double us_per_tick = stats::NanosecondsPerTick() / 1e3;
+	*calls = static_cast<cell>(entry->calls);
+	*total_time = FloatToCell(static_cast<float>(entry->total_ticks * us_per_tick));
+	*max_time = FloatToCell(static_cast<float>(entry->max_ticks * us_per_tick));
+	*p50_time = FloatToCell(static_cast<float>(stats::Percentile(*entry, 0.5) * us_per_tick));
+	*p99_time = FloatToCell(static_cast<float>(stats::Percentile(*entry, 0.99) * us_per_tick));
+	return 1;
+}
+
+/// <summary>
+/// Writes the call counts and timings of every native called so far to a file.
+/// </summary>
+/// <param name="amx"> Vector_DumpStats </param>
+/// <param name="params"> const file_name[] </param>
+/// <returns> 1 if the file has been written, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_DumpStats(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	int error;
+	std::string file_name = pluginutils::GetCXXString(amx, params[1], error);
+	if (error != AMX_ERR_NONE)
+		return 0;
+	if (!stats::Dump(file_name.c_str()))
+		return logprintf("%s: Could not open the file \"%s\".", pluginutils::GetCurrentNativeFunctionName(amx), file_name.c_str()), 0;
+	return 1;
+}
+
+/// <summary>
+/// Clears the call counts and timings of every native.
+/// </summary>
+/// <param name="amx"> Vector_ResetStats </param>
+/// <param name="params"> none </param>
+/// <returns> 1 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_ResetStats(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 0;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	stats::Reset();
+	return 1;
 }
 
 /// <summary>
@@ -90,11 +502,12 @@ static cell AMX_NATIVE_CALL n_Vector_Size(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	VectorObject *vector = vectors.Get(params[1]);
+	if (vector == NULL)
 		return -1;
 
-	auto size = vectors[static_cast<unsigned long int>(params[1]) - 1].size();
-	if (debugging) logprintf("%s: Returning the size of vector %d as %d.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[1]), size);
+	auto size = vector->Size();
+	TRACE("Vector_Size", "Returning the size of vector %d as %d.", static_cast<int>(params[1]), static_cast<int>(size));
 	return size;
 }
 
@@ -110,11 +523,12 @@ static cell AMX_NATIVE_CALL n_Vector_Odd(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
 
-	auto size = vectors[static_cast<unsigned long int>(params[1]) - 1].size();
-	if (debugging) logprintf("%s: The size of vector %d is %d, and the return will be %s.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[1]), size, size % 2 == 1 ? "true" : "false");
+	auto size = vector->Size();
+	TRACE("Vector_Odd", "The size of vector %d is %d, and the return will be %s.", static_cast<int>(params[1]), static_cast<int>(size), size % 2 == 1 ? "true" : "false");
 	return size % 2 == 1;
 }
 
@@ -130,11 +544,12 @@ static cell AMX_NATIVE_CALL n_Vector_Even(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
 
-	auto size = vectors[static_cast<unsigned long int>(params[1]) - 1].size();
-	if (debugging) logprintf("%s: The size of vector %d is %d, and the return will be %s.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[1]), size, size % 2 == 0 ? "true" : "false");
+	auto size = vector->Size();
+	TRACE("Vector_Even", "The size of vector %d is %d, and the return will be %s.", static_cast<int>(params[1]), static_cast<int>(size), size % 2 == 0 ? "true" : "false");
 	return size % 2 == 0;
 }
 
@@ -150,12 +565,119 @@ static cell AMX_NATIVE_CALL n_Vector_Empty(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	VectorObject *vector = vectors.Get(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	auto size = vector->Size();
+	TRACE("Vector_Empty", "The size of vector %d is %d, and the return will be %s.", static_cast<int>(params[1]), static_cast<int>(size), size == 0 ? "true" : "false");
+	return vector->Empty();
+}
+
+/// <summary>
+/// Makes room for a number of elements, so adding them won't grow the vector storage.
+/// </summary>
+/// <param name="amx"> Vector_Reserve </param>
+/// <param name="params"> vectorID, count </param>
+/// <returns> 1 if the room has been made, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Reserve(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	if (params[2] < 0 || params[2] > MAX_RESERVE)
+		return logprintf("%s: Can't reserve room for %d elements, the limit is %d.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[2]), static_cast<int>(MAX_RESERVE)), 0;
+
+	vector->Reserve(static_cast<size_t>(params[2]));
+	TRACE("Vector_Reserve", "Reserved room for %d elements in vector %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Releases the memory the vector holds beyond its current elements.
+/// </summary>
+/// <param name="amx"> Vector_ShrinkToFit </param>
+/// <param name="params"> vectorID </param>
+/// <returns> 1 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_ShrinkToFit(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	vector->ShrinkToFit();
+	TRACE("Vector_ShrinkToFit", "Shrunk vector %d to %d elements.", static_cast<int>(params[1]), static_cast<int>(vector->Capacity()));
+	return 1;
+}
+
+/// <summary>
+/// Shows how many elements the vector can hold before its storage grows.
+/// </summary>
+/// <param name="amx"> Vector_Capacity </param>
+/// <param name="params"> vectorID </param>
+/// <returns> capacity of vectorID </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Capacity(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
 
-	auto size = vectors[static_cast<unsigned long int>(params[1]) - 1].size();
-	if (debugging) logprintf("%s: The size of vector %d is %d, and the return will be %s.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[1]), size, size == 0 ? "true" : "false");
-	return vectors[static_cast<int>(params[1]) - 1].empty();
+	return static_cast<cell>(vector->Capacity());
+}
+
+/// <summary>
+/// Shows the bytes held by all the vectors, maps and queues of the plugin, including their hash indexes and the handle tables.
+/// </summary>
+/// <param name="amx"> Vector_MemoryUsage </param>
+/// <param name="params"> none </param>
+/// <returns> the number of bytes, capped at cellmax </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_MemoryUsage(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 0;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	return ClampToCell(MemoryUsage());
+}
+
+/// <summary>
+/// Shows how the memory of the vector storage pool is used, all values in bytes.
+/// reserved - used is held in free lists or unused slab space, used - requested is lost to size class rounding.
+/// </summary>
+/// <param name="amx"> Vector_PoolStats </param>
+/// <param name="params"> &reserved, &used, &requested, &free </param>
+/// <returns> 1, or 0 if a reference is invalid </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_PoolStats(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	cell *reserved, *used, *requested, *free_bytes;
+	if (amx_GetAddr(amx, params[1], &reserved) != AMX_ERR_NONE || amx_GetAddr(amx, params[2], &used) != AMX_ERR_NONE ||
+		amx_GetAddr(amx, params[3], &requested) != AMX_ERR_NONE || amx_GetAddr(amx, params[4], &free_bytes) != AMX_ERR_NONE)
+		return 0;
+
+	const pool::Stats stats = pool::GetStats();
+	*reserved = ClampToCell(stats.reserved);
+	*used = ClampToCell(stats.used);
+	*requested = ClampToCell(stats.requested);
+	*free_bytes = ClampToCell(stats.free);
+	return 1;
 }
 
 /// <summary>
@@ -163,20 +685,22 @@ static cell AMX_NATIVE_CALL n_Vector_Empty(AMX* amx, cell* params)
 /// </summary>
 /// <param name="amx"> Vector_Add </param>
 /// <param name="params"> vectorID, value </param>
-/// <returns> 1 </returns>
+/// <returns> 1 if element has been added, 0 if it already exists, -1 for a string vector (see Vector_AddString) </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_Add(AMX* amx, cell* params)
 {
 	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() == DenseSet::ELEMENT_STRING)
 		return -1;
 	
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	if (debugging) logprintf("%s: Adding element to vector %d, value %d.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[1]), static_cast<int>(params[2]));
-	vectors[vectorID].insert(static_cast<int>(params[2]));
-	copy_vectors[vectorID].push_back(static_cast<int>(params[2]));
+	if (!vector->Insert(vector->ToKey(params[2]))) {
+		TRACE("Vector_Add", "The value %d already exists in vector %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+		return 0;
+	}
+	TRACE("Vector_Add", "Adding element to vector %d, value %d.", static_cast<int>(params[1]), static_cast<int>(params[2]));
 	return 1;
 }
 
@@ -192,22 +716,22 @@ static cell AMX_NATIVE_CALL n_Vector_Clear(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	VectorObject *vector = vectors.Get(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0) {
-		if (debugging) logprintf("%s: The vector %d it's already empty.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<unsigned long int>(params[1]) - 1);
+	if (vector->Size() == 0) {
+		TRACE("Vector_Clear", "The vector %d it's already empty.", static_cast<int>(params[1]));
 		return 0;
 	}
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	if (debugging) logprintf("%s: Clearing %d elements from vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), vectors[vectorID].size(), vectorID + 1);
-	vectors[vectorID].clear();
-	copy_vectors[vectorID].clear();
+	TRACE("Vector_Clear", "Clearing %d elements from vector %d.", static_cast<int>(vector->Size()), static_cast<int>(params[1]));
+	vector->Clear();
 	return 1;
 }
 
 /// <summary>
 /// Deletes a specific value from vector.
+/// The last element of the vector takes its place.
 /// </summary>
 /// <param name="amx"> Vector_Remove </param>
 /// <param name="params"> vectorID, value </param>
@@ -215,44 +739,42 @@ static cell AMX_NATIVE_CALL n_Vector_Clear(AMX* amx, cell* params)
 
 static cell AMX_NATIVE_CALL n_Vector_Remove(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].find(static_cast<int>(params[2])) == vectors[static_cast<unsigned long int>(params[1]) - 1].end())
-		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
 	int value = static_cast<int>(params[2]);
-	if (debugging) logprintf("%s: Removed element %d from vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), value, vectorID + 1);
-	vectors[vectorID].erase(value);
-	copy_vectors[vectorID].erase(std::lower_bound(copy_vectors[vectorID].begin(), copy_vectors[vectorID].end(), value));
+	if (!vector->Erase(vector->ToKey(value)))
+		return 0;
+	TRACE("Vector_Remove", "Removed element %d from vector %d.", value, static_cast<int>(params[1]));
 	return 1;
 }
 
 /// <summary>
-/// Deletes a specific value from vector.
+/// Deletes the element at a specific index from vector.
+/// The last element of the vector takes its place.
 /// </summary>
-/// <param name="amx"> Vector_Remove </param>
-/// <param name="params"> vectorID, value </param>
+/// <param name="amx"> Vector_Delete </param>
+/// <param name="params"> vectorID, index </param>
 /// <returns> 1 if element has been removed, otherwise returns 0 </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_Delete(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (static_cast<int>(params[2]) < 0 || static_cast<unsigned int>(params[2]) >= vectors[static_cast<unsigned long int>(params[1]) - 1].size())
+	if (static_cast<int>(params[2]) < 0 || static_cast<unsigned int>(params[2]) >= vector->Size())
 		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	int value = static_cast<int>(params[2]);
-	if (debugging) logprintf("%s: Removed element at index %d from vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), value, vectorID + 1);
-	vectors[vectorID].erase(vectors[static_cast<unsigned long int>(params[1]) - 1].find(value));
-	copy_vectors[vectorID].erase(copy_vectors[vectorID].begin() + value);
+	int index = static_cast<int>(params[2]);
+	TRACE("Vector_Delete", "Removed element at index %d from vector %d.", index, static_cast<int>(params[1]));
+	vector->EraseAt(index);
 	return 1;
 }
 
@@ -261,21 +783,22 @@ static cell AMX_NATIVE_CALL n_Vector_Delete(AMX* amx, cell* params)
 /// </summary>
 /// <param name="amx"> Vector_Begin </param>
 /// <param name="params"> vectorID </param>
-/// <returns> Returns the first element from vector minus one unit. </returns>
+/// <returns> Returns the first element from vector minus one unit, -1 for a Float or string vector. </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_Begin(AMX* amx, cell* params)
 {
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	// One unit away from a Float key is the neighbouring bit pattern, not a sentinel.
+	if (vector == NULL || vector->Type() != DenseSet::ELEMENT_INT)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto it = copy_vectors[vectorID][0] - 1;
-	if (debugging) logprintf("%s: Returning the value %d for vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), it, vectorID + 1);
+	auto it = vector->ToValue(vector->Front() - 1);
+	TRACE("Vector_Begin", "Returning the value %d for vector %d.", it, static_cast<int>(params[1]));
 	return it;
 }
 
@@ -284,21 +807,22 @@ static cell AMX_NATIVE_CALL n_Vector_Begin(AMX* amx, cell* params)
 /// </summary>
 /// <param name="amx"> Vector_End </param>
 /// <param name="params"> vectorID </param>
-/// <returns> Returns the last element from vector plus one unit. </returns>
+/// <returns> Returns the last element from vector plus one unit, -1 for a Float or string vector. </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_End(AMX* amx, cell* params)
 {
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() != DenseSet::ELEMENT_INT)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	if (debugging) logprintf("%s: Returning the value %d for vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), copy_vectors[vectorID][copy_vectors[vectorID].size() - 1] + 1, vectorID + 1);
-	return copy_vectors[vectorID][copy_vectors[vectorID].size() - 1] + 1;
+	auto it = vector->ToValue(vector->Back() + 1);
+	TRACE("Vector_End", "Returning the value %d for vector %d.", it, static_cast<int>(params[1]));
+	return it;
 }
 
 /// <summary>
@@ -313,14 +837,14 @@ static cell AMX_NATIVE_CALL n_Vector_First(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto it = copy_vectors[vectorID][0];
-	if (debugging) logprintf("%s: Returning the value %d for vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), it, vectorID + 1);
+	auto it = vector->ToValue(vector->Front());
+	TRACE("Vector_First", "Returning the value %d for vector %d.", it, static_cast<int>(params[1]));
 	return it;
 }
 
@@ -336,14 +860,14 @@ static cell AMX_NATIVE_CALL n_Vector_Last(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return 0;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto it = copy_vectors[vectorID][copy_vectors[vectorID].size() - 1];
-	if (debugging) logprintf("%s: Returning the value %d for vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), it, vectorID + 1);
+	auto it = vector->ToValue(vector->Back());
+	TRACE("Vector_Last", "Returning the value %d for vector %d.", it, static_cast<int>(params[1]));
 	return it;
 }
 
@@ -356,20 +880,20 @@ static cell AMX_NATIVE_CALL n_Vector_Last(AMX* amx, cell* params)
 
 static cell AMX_NATIVE_CALL n_Vector_Next(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() < 2 || vectors[static_cast<unsigned long int>(params[1]) - 1].count(static_cast<int>(params[2])) == 0)
+
+	int index = vector->IndexOf(vector->ToKey(params[2]));
+	if (index == -1 || static_cast<size_t>(index) + 1 >= vector->Size())
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	//auto it = std::next(vectors[vectorID].find(static_cast<int>(params[2])));
-	auto it = vectors[vectorID].find(static_cast<int>(params[2]));
-	std::advance(it, 1);
-	if (debugging) logprintf("%s: Returning the value %d for vector %d, given value %d.", pluginutils::GetCurrentNativeFunctionName(amx), *it, vectorID + 1, static_cast<int>(params[2]));
-	return *it;
+	auto it = vector->ToValue(vector->At(index + 1));
+	TRACE("Vector_Next", "Returning the value %d for vector %d, given value %d.", it, static_cast<int>(params[1]), static_cast<int>(params[2]));
+	return it;
 }
 
 /// <summary>
@@ -381,20 +905,20 @@ static cell AMX_NATIVE_CALL n_Vector_Next(AMX* amx, cell* params)
 
 static cell AMX_NATIVE_CALL n_Vector_Prev(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() < 2 || vectors[static_cast<unsigned long int>(params[1]) - 1].count(static_cast<int>(params[2])) == 0)
+
+	int index = vector->IndexOf(vector->ToKey(params[2]));
+	if (index < 1)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	//auto it = std::prev(vectors[vectorID].find(static_cast<int>(params[2])));
-	auto it = vectors[vectorID].find(static_cast<int>(params[2]));
-	std::advance(it, -1);
-	if (debugging) logprintf("%s: Returning the value %d for vector %d, given value %d.", pluginutils::GetCurrentNativeFunctionName(amx), *it, vectorID + 1, static_cast<int>(params[2]));
-	return *it;
+	auto it = vector->ToValue(vector->At(index - 1));
+	TRACE("Vector_Prev", "Returning the value %d for vector %d, given value %d.", it, static_cast<int>(params[1]), static_cast<int>(params[2]));
+	return it;
 }
 
 /// <summary>
@@ -425,15 +949,16 @@ static cell AMX_NATIVE_CALL n_Vector_Random(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto number = randInt(vectors[vectorID].size());
-	if (debugging) logprintf("%s: Returning the value %d for vector %d.", pluginutils::GetCurrentNativeFunctionName(amx), copy_vectors[vectorID][number], vectorID + 1);
-	return copy_vectors[vectorID][number];
+	auto number = randInt(vector->Size());
+	auto it = vector->ToValue(vector->At(number));
+	TRACE("Vector_Random", "Returning the value %d for vector %d.", it, static_cast<int>(params[1]));
+	return it;
 }
 
 /// <summary>
@@ -448,16 +973,15 @@ static cell AMX_NATIVE_CALL n_Vector_PopBack(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	int value = copy_vectors[vectorID][copy_vectors[vectorID].size() - 1];
-	vectors[vectorID].erase(vectors[vectorID].end());
-	copy_vectors[vectorID].erase(copy_vectors[vectorID].end());
-	if (debugging) logprintf("%s: Returning the value %d for vector %d after removing it.", pluginutils::GetCurrentNativeFunctionName(amx), value, vectorID + 1);
+	int value = vector->ToValue(vector->Back());
+	vector->EraseAt(vector->Size() - 1);
+	TRACE("Vector_PopBack", "Returning the value %d for vector %d after removing it.", value, static_cast<int>(params[1]));
 	return value;
 }
 
@@ -473,17 +997,16 @@ static cell AMX_NATIVE_CALL n_Vector_PopFront(AMX* amx, cell* params)
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (vector->Size() == 0)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto it = vectors[vectorID].begin();
-	vectors[vectorID].erase(it);
-	copy_vectors[vectorID].erase(copy_vectors[vectorID].begin());
-	if (debugging) logprintf("%s: Returning the value %d for vector %d after removing it.", pluginutils::GetCurrentNativeFunctionName(amx), *it, vectorID + 1);
-	return *it;
+	int value = vector->ToValue(vector->Front());
+	vector->EraseAtOrdered(0);
+	TRACE("Vector_PopFront", "Returning the value %d for vector %d after removing it.", value, static_cast<int>(params[1]));
+	return value;
 }
 
 /// <summary>
@@ -495,17 +1018,17 @@ static cell AMX_NATIVE_CALL n_Vector_PopFront(AMX* amx, cell* params)
 
 static cell AMX_NATIVE_CALL n_Vector_FindValue(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (static_cast<unsigned long int>(params[2]) < 0 || static_cast<unsigned long int>(params[2]) >= vectors[static_cast<unsigned long int>(params[1]) - 1].size() || vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (static_cast<unsigned long int>(params[2]) < 0 || static_cast<unsigned long int>(params[2]) >= vector->Size() || vector->Size() == 0)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	int value = copy_vectors[vectorID][static_cast<int>(params[2])];
-	if (debugging) logprintf("%s: Returning the value %d for vector %d after searching at index %d.", pluginutils::GetCurrentNativeFunctionName(amx), value, vectorID + 1, static_cast<unsigned long int>(params[2]));
+	int value = vector->ToValue(vector->At(static_cast<int>(params[2])));
+	TRACE("Vector_FindValue", "Returning the value %d for vector %d after searching at index %d.", value, static_cast<int>(params[1]), static_cast<int>(params[2]));
 	return value;
 }
 
@@ -518,19 +1041,19 @@ static cell AMX_NATIVE_CALL n_Vector_FindValue(AMX* amx, cell* params)
 
 static cell AMX_NATIVE_CALL n_Vector_FindIndex(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 2;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0 || vectors[static_cast<unsigned long int>(params[1]) - 1].count(static_cast<int>(params[2])) == 0) {
-		if (debugging) logprintf("%s: No element found with value %d in vector %d, returning -1.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<unsigned long int>(params[2]), static_cast<unsigned long int>(params[1]));
+
+	int index = vector->IndexOf(vector->ToKey(params[2]));
+	if (index == -1) {
+		TRACE("Vector_FindIndex", "No element found with value %d in vector %d, returning -1.", static_cast<int>(params[2]), static_cast<int>(params[1]));
 		return -1;
 	}
-
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	int index = std::distance(copy_vectors[vectorID].begin(), std::lower_bound(copy_vectors[vectorID].begin(), copy_vectors[vectorID].end(), static_cast<int>(params[2])));
-	if (debugging) logprintf("%s: Returning the value %d for vector %d after searching for element %d.", pluginutils::GetCurrentNativeFunctionName(amx), index, vectorID + 1, static_cast<unsigned long int>(params[2]));
+	TRACE("Vector_FindIndex", "Returning the value %d for vector %d after searching for element %d.", index, static_cast<int>(params[1]), static_cast<int>(params[2]));
 	return index;
 }
 
@@ -539,27 +1062,26 @@ static cell AMX_NATIVE_CALL n_Vector_FindIndex(AMX* amx, cell* params)
 /// </summary>
 /// <param name="amx"> Vector_ReplaceIndex </param>
 /// <param name="params"> vectorID, index, new_value </param>
-/// <returns> Replaces the value at given index with new_value. If index is invalid, it returns -1 </returns>
+/// <returns> Replaces the value at given index with new_value. If index is invalid or the vector is a string vector, it returns -1, if new_value already exists, it returns 0 </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_ReplaceIndex(AMX* amx, cell* params)
 {
-	unsigned short int num_args = 1;
+	unsigned short int num_args = 3;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() == DenseSet::ELEMENT_STRING)
 		return -1;
-	if (static_cast<unsigned long int>(params[2]) < 0 || static_cast<unsigned long int>(params[2]) >= vectors[static_cast<unsigned long int>(params[1]) - 1].size() || vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+	if (static_cast<unsigned long int>(params[2]) < 0 || static_cast<unsigned long int>(params[2]) >= vector->Size() || vector->Size() == 0)
 		return -1;
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	int replaced = *(std::next(vectors[vectorID].begin(), static_cast<int>(params[2])));
+	int replaced = vector->ToValue(vector->At(static_cast<int>(params[2])));
+	if (!vector->ReplaceAt(static_cast<int>(params[2]), vector->ToKey(params[3]))) {
+		TRACE("Vector_ReplaceIndex", "The value %d already exists in vector %d.", static_cast<int>(params[3]), static_cast<int>(params[1]));
+		return 0;
+	}
 
-	copy_vectors[vectorID][static_cast<int>(params[2])] = static_cast<int>(params[3]);
-	vectors[vectorID].clear();
-	for (const int& i : copy_vectors[vectorID])
-		vectors[vectorID].insert(i);
-	
-	if (debugging) logprintf("%s: Replacing value %d with %d in vector %d with index %d.", pluginutils::GetCurrentNativeFunctionName(amx), replaced, static_cast<unsigned long int>(params[3]), vectorID + 1, static_cast<unsigned long int>(params[2]));
+	TRACE("Vector_ReplaceIndex", "Replacing value %d with %d in vector %d with index %d.", replaced, static_cast<int>(params[3]), static_cast<int>(params[1]), static_cast<int>(params[2]));
 	return 1;
 }
 
@@ -568,60 +1090,1633 @@ static cell AMX_NATIVE_CALL n_Vector_ReplaceIndex(AMX* amx, cell* params)
 /// </summary>
 /// <param name="amx"> Vector_Replace </param>
 /// <param name="params"> vectorID, old_value, new_value </param>
-/// <returns> Replaces the old_value with new_value. If old_value doesn't exists, it returns -1 </returns>
+/// <returns> Replaces the old_value with new_value. If old_value doesn't exists or the vector is a string vector, it returns -1, if new_value already exists, it returns 0 </returns>
 
 static cell AMX_NATIVE_CALL n_Vector_Replace(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() == DenseSet::ELEMENT_STRING)
+		return -1;
+
+	int index = vector->IndexOf(vector->ToKey(params[2]));
+	if (index == -1) {
+		TRACE("Vector_Replace", "No element found with value %d in vector %d, returning -1.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+		return -1;
+	}
+	if (!vector->ReplaceAt(index, vector->ToKey(params[3]))) {
+		TRACE("Vector_Replace", "The value %d already exists in vector %d.", static_cast<int>(params[3]), static_cast<int>(params[1]));
+		return 0;
+	}
+
+	TRACE("Vector_Replace", "Replacing value %d with %d in vector %d with index %d.", static_cast<int>(params[2]), static_cast<int>(params[3]), static_cast<int>(params[1]), index);
+	return 1;
+}
+
+/// <summary>
+/// Starts an iteration over the vector.
+/// </summary>
+/// <param name="amx"> Vector_IterBegin </param>
+/// <param name="params"> vectorID </param>
+/// <returns> The cursor to be passed to Vector_IterNext, -1 if the vector doesn't exist. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_IterBegin(AMX* amx, cell* params)
 {
 	unsigned short int num_args = 1;
 	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
 		return 0;
-	if (static_cast<unsigned long int>(params[1]) < 1 || static_cast<unsigned long int>(params[1]) > vctID)
+	if (GetVector(params[1]) == NULL)
+		return -1;
+
+	TRACE("Vector_IterBegin", "Starting an iteration over vector %d.", static_cast<int>(params[1]));
+	return 0;
+}
+
+/// <summary>
+/// Advances an iteration over the vector.
+/// </summary>
+/// <param name="amx"> Vector_IterNext </param>
+/// <param name="params"> vectorID, &cursor, &value </param>
+/// <returns> 1 and stores the next element in value, or 0 when the end of the vector has been reached. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_IterNext(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return 0;
+
+	cell *cursor, *value;
+	if (amx_GetAddr(amx, params[2], &cursor) != AMX_ERR_NONE || amx_GetAddr(amx, params[3], &value) != AMX_ERR_NONE)
+		return 0;
+
+	if (*cursor < 0 || static_cast<size_t>(*cursor) >= vector->Size())
+		return 0;
+
+	*value = static_cast<cell>(vector->ToValue(vector->At(static_cast<size_t>(*cursor))));
+	TRACE("Vector_IterNext", "Returning the value %d for vector %d at index %d.", static_cast<int>(*value), static_cast<int>(params[1]), static_cast<int>(*cursor));
+	++*cursor;
+	return 1;
+}
+
+/// <summary>
+/// Removes the element returned by the last Vector_IterNext call.
+/// The last element of the vector takes its place and will be returned by the next Vector_IterNext call.
+/// </summary>
+/// <param name="amx"> Vector_IterRemove </param>
+/// <param name="params"> vectorID, &cursor </param>
+/// <returns> 1 if element has been removed, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_IterRemove(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	cell *cursor;
+	if (amx_GetAddr(amx, params[2], &cursor) != AMX_ERR_NONE)
+		return 0;
+
+	if (*cursor < 1 || static_cast<size_t>(*cursor) > vector->Size())
+		return 0;
+
+	--*cursor;
+	TRACE("Vector_IterRemove", "Removed element %d from vector %d while iterating.", vector->At(*cursor), static_cast<int>(params[1]));
+	vector->EraseAt(static_cast<size_t>(*cursor));
+	return 1;
+}
+
+/// <summary>
+/// Copies the elements of the vector into an array.
+/// </summary>
+/// <param name="amx"> Vector_ToArray </param>
+/// <param name="params"> vectorID, dest[], maxlen, offset </param>
+/// <returns> The number of elements copied. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_ToArray(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
 		return -1;
-	if (vectors[static_cast<unsigned long int>(params[1]) - 1].size() == 0)
+
+	if (params[3] <= 0 || params[4] < 0 || static_cast<size_t>(params[4]) >= vector->Size())
+		return 0;
+
+	cell *dest;
+	if (amx_GetAddr(amx, params[2], &dest) != AMX_ERR_NONE)
+		return 0;
+
+	size_t count = vector->Size() - static_cast<size_t>(params[4]);
+	if (count > static_cast<size_t>(params[3]))
+		count = static_cast<size_t>(params[3]);
+	if (vector->Type() == DenseSet::ELEMENT_INT)
+		std::copy(vector->Data() + params[4], vector->Data() + params[4] + count, dest);
+	else
+		for (size_t i = 0; i < count; ++i)
+			dest[i] = vector->ToValue(vector->At(static_cast<size_t>(params[4]) + i));
+	TRACE("Vector_ToArray", "Copied %d elements from vector %d starting at index %d.", static_cast<int>(count), static_cast<int>(params[1]), static_cast<int>(params[4]));
+	return static_cast<cell>(count);
+}
+
+/// <summary>
+/// Adds the elements of an array into the vector.
+/// </summary>
+/// <param name="amx"> Vector_AddArray </param>
+/// <param name="params"> vectorID, const src[], len </param>
+/// <returns> The number of elements added, the ones that already exist are skipped. -1 for a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_AddArray(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() == DenseSet::ELEMENT_STRING)
+		return -1;
+	if (params[3] <= 0)
+		return 0;
+
+	cell *src;
+	if (amx_GetAddr(amx, params[2], &src) != AMX_ERR_NONE)
+		return 0;
+
+	size_t added = vector->Append(ToKeys(*vector, src, static_cast<size_t>(params[3])), static_cast<size_t>(params[3]));
+	TRACE("Vector_AddArray", "Added %d of %d elements to vector %d.", static_cast<int>(added), static_cast<int>(params[3]), static_cast<int>(params[1]));
+	return static_cast<cell>(added);
+}
+
+/// <summary>
+/// Replaces the elements of the vector with the elements of an array.
+/// </summary>
+/// <param name="amx"> Vector_Assign </param>
+/// <param name="params"> vectorID, const src[], len </param>
+/// <returns> The new size of the vector, duplicated elements are skipped. -1 for a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Assign(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() == DenseSet::ELEMENT_STRING)
 		return -1;
+	if (params[3] < 0)
+		return 0;
+
+	cell *src;
+	if (amx_GetAddr(amx, params[2], &src) != AMX_ERR_NONE)
+		return 0;
+
+	size_t size = vector->Assign(ToKeys(*vector, src, static_cast<size_t>(params[3])), static_cast<size_t>(params[3]));
+	TRACE("Vector_Assign", "Assigned %d elements to vector %d.", static_cast<int>(size), static_cast<int>(params[1]));
+	return static_cast<cell>(size);
+}
+
+/// <summary>
+/// Applies a packed list of add/remove/replace/clear operations, which may target different vectors, in a single call.
+/// </summary>
+/// <param name="amx"> Vector_Batch </param>
+/// <param name="params"> operations, length </param>
+/// <returns> The number of operations which changed a vector, -1 if the list is malformed </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Batch(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	if (params[2] <= 0)
+		return 0;
+
+	cell *ops;
+	if (amx_GetAddr(amx, params[1], &ops) != AMX_ERR_NONE)
+		return 0;
+	const size_t length = static_cast<size_t>(params[2]);
+	// A malformed list isn't applied at all, rather than up to the bad operation.
+	// The operands are ints, which can't be stored in string vectors.
+	for (size_t i = 0; i < length; i += BatchOperationLength(ops[i])) {
+		if (BatchOperationLength(ops[i]) == 0 || length - i < BatchOperationLength(ops[i])) {
+			logprintf("%s: %s: Malformed operation at offset %d.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(i));
+			return -1;
+		}
+		const DenseSet *target = GetVector(ops[i + 1]);
+		if (target != NULL && target->Type() == DenseSet::ELEMENT_STRING) {
+			logprintf("%s: %s: The operation at offset %d targets the string vector %d.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(i), static_cast<int>(ops[i + 1]));
+			return -1;
+		}
+	}
+
+	size_t applied = 0;
+	cell handle = 0;
+	DenseSet *vector = NULL;
+	for (size_t i = 0; i < length; i += BatchOperationLength(ops[i])) {
+		// Runs of operations on the same vector only look the handle up once.
+		if (ops[i + 1] != handle) {
+			handle = ops[i + 1];
+			vector = GetVector(handle);
+		}
+		if (vector == NULL)
+			continue;
+		if (ops[i] == BATCH_ADD) {
+			// Consecutive adds to a vector are appended together: the storage grows at most once and a sorted vector is merged once.
+			batch_values.clear();
+			size_t next = i;
+			for (; next < length && ops[next] == BATCH_ADD && ops[next + 1] == handle; next += 3)
+				batch_values.push_back(vector->ToKey(ops[next + 2]));
+			applied += vector->Append(batch_values.data(), batch_values.size());
+			i = next - 3;
+		}
+		else if (ops[i] == BATCH_REMOVE) {
+			if (vector->Erase(vector->ToKey(ops[i + 2])))
+				++applied;
+		}
+		else if (ops[i] == BATCH_REPLACE) {
+			const int index = vector->IndexOf(vector->ToKey(ops[i + 2]));
+			if (index != -1 && ops[i + 2] != ops[i + 3] && vector->ReplaceAt(static_cast<size_t>(index), vector->ToKey(ops[i + 3])))
+				++applied;
+		}
+		else if (!vector->Empty()) {
+			vector->Clear();
+			++applied;
+		}
+	}
+	TRACE("Vector_Batch", "Applied %d operations out of a list of %d cells.", static_cast<int>(applied), static_cast<int>(length));
+	return ClampToCell(applied);
+}
+
+/// <summary>
+/// Adds a string to a string vector. The text is stored once in the plugin-wide string pool, whatever the number of vectors holding it.
+/// </summary>
+/// <param name="amx"> Vector_AddString </param>
+/// <param name="params"> vectorID, const string[] </param>
+/// <returns> 1 if the string has been added, 0 if it already exists, -1 if the vector isn't a string vector </returns>
 
-	unsigned long int vectorID = static_cast<unsigned long int>(params[1]) - 1;
-	auto it = vectors[vectorID].find(static_cast<int>(params[2]));
-	if (it == vectors[vectorID].end()) {
-		if (debugging) logprintf("%s: No element found with value %d in vector %d, returning -1.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<unsigned long int>(params[2]), vectorID + 1);
+static cell AMX_NATIVE_CALL n_Vector_AddString(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() != DenseSet::ELEMENT_STRING)
 		return -1;
+
+	int error;
+	const char *text = pluginutils::GetCString(amx, params[2], error);
+	if (text == NULL)
+		return 0;
+	const size_t length = strlen(text);
+	int id = stringpool::Find(text, length);
+	if (id == -1) {
+		if (stringpool::Count() >= next_string_collection)
+			CollectStrings();
+		id = stringpool::Intern(text, length);
 	}
-	int index = std::distance(vectors[vectorID].begin(), it);
-	
-	copy_vectors[vectorID][index] = static_cast<int>(params[3]);
-	vectors[vectorID].clear();
-	for (const int& i : copy_vectors[vectorID])
-		vectors[vectorID].insert(i);
+	if (!vector->Insert(id)) {
+		TRACE("Vector_AddString", "The string \"%s\" already exists in vector %d.", text, static_cast<int>(params[1]));
+		return 0;
+	}
+	TRACE("Vector_AddString", "Adding the string \"%s\" to vector %d.", text, static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Copies the string at the given index of a string vector.
+/// </summary>
+/// <param name="amx"> Vector_GetString </param>
+/// <param name="params"> vectorID, index, dest[], maxlength </param>
+/// <returns> The number of characters copied, -1 if the vector isn't a string vector or the index is invalid </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_GetString(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() != DenseSet::ELEMENT_STRING)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= vector->Size())
+		return -1;
+
+	const char *text = stringpool::Get(vector->At(static_cast<size_t>(params[2])));
+	if (text == NULL || params[4] <= 0)
+		return -1;
+	if (!pluginutils::SetCString(amx, params[3], params[4], text))
+		return 0;
+	const size_t length = std::min(strlen(text), static_cast<size_t>(params[4] - 1));
+	TRACE("Vector_GetString", "Returning the string \"%s\" at index %d of vector %d.", text, static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return static_cast<cell>(length);
+}
+
+/// <summary>
+/// Finds the index of a string in a string vector.
+/// </summary>
+/// <param name="amx"> Vector_FindString </param>
+/// <param name="params"> vectorID, const string[] </param>
+/// <returns> The index of the string, -1 if it isn't in the vector or the vector isn't a string vector </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_FindString(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || vector->Type() != DenseSet::ELEMENT_STRING)
+		return -1;
+
+	int error;
+	const char *text = pluginutils::GetCString(amx, params[2], error);
+	if (text == NULL)
+		return -1;
+	// A string which isn't in the pool isn't in any vector.
+	const int id = stringpool::Find(text, strlen(text));
+	const int index = (id == -1) ? -1 : vector->IndexOf(id);
+	TRACE("Vector_FindString", "Returning the index %d for the string \"%s\" in vector %d.", index, text, static_cast<int>(params[1]));
+	return static_cast<cell>(index);
+}
+
+enum SetOperation
+{
+	SET_UNION,
+	SET_INTERSECTION,
+	SET_DIFFERENCE
+};
+
+/// <summary>
+/// Computes a set operation between two vectors and stores the result in a third one.
+/// The destination can be one of the operands.
+/// </summary>
+/// <returns> The size of the destination vector. </returns>
+
+static cell SetOperationNative(AMX* amx, cell* params, SetOperation operation)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector_a = GetVector(params[1]), *vector_b = GetVector(params[2]);
+	DenseSet *destination = GetVector(params[3]);
+	if (vector_a == NULL || vector_b == NULL || destination == NULL)
+		return -1;
+	// The keys of ints and Floats can't be mixed.
+	if (vector_a->Type() != destination->Type() || vector_b->Type() != destination->Type())
+		return -1;
+
+	std::vector<int> &result = set_operation_result;
+	const DenseSet &a = *vector_a, &b = *vector_b;
+	result.clear();
+	switch (operation)
+	{
+	case SET_UNION:
+		result.assign(a.Data(), a.Data() + a.Size());
+		for (size_t i = 0; i < b.Size(); ++i)
+			if (!a.Contains(b.At(i)))
+				result.push_back(b.At(i));
+		break;
+	case SET_INTERSECTION:
+	{ // Walk the smaller side and probe the larger one.
+		const DenseSet &small = (a.Size() <= b.Size()) ? a : b;
+		const DenseSet &large = (a.Size() <= b.Size()) ? b : a;
+		for (size_t i = 0; i < small.Size(); ++i)
+			if (large.Contains(small.At(i)))
+				result.push_back(small.At(i));
+		break;
+	}
+	case SET_DIFFERENCE:
+		for (size_t i = 0; i < a.Size(); ++i)
+			if (!b.Contains(a.At(i)))
+				result.push_back(a.At(i));
+		break;
+	}
+
+	destination->Assign(result.data(), result.size());
+	// Each native needs its own literal TRACE, a trace point is created once per call site.
+	const int size = static_cast<int>(result.size());
+	switch (operation)
+	{
+	case SET_UNION:
+		TRACE("Vector_Union", "Stored %d elements in vector %d from vectors %d and %d.", size, static_cast<int>(params[3]), static_cast<int>(params[1]), static_cast<int>(params[2]));
+		break;
+	case SET_INTERSECTION:
+		TRACE("Vector_Intersect", "Stored %d elements in vector %d from vectors %d and %d.", size, static_cast<int>(params[3]), static_cast<int>(params[1]), static_cast<int>(params[2]));
+		break;
+	case SET_DIFFERENCE:
+		TRACE("Vector_Difference", "Stored %d elements in vector %d from vectors %d and %d.", size, static_cast<int>(params[3]), static_cast<int>(params[1]), static_cast<int>(params[2]));
+		break;
+	}
+	return static_cast<cell>(result.size());
+}
+
+/// <summary>
+/// Stores the elements which are in any of the two vectors.
+/// </summary>
+/// <param name="amx"> Vector_Union </param>
+/// <param name="params"> vectorA, vectorB, destination </param>
+/// <returns> The size of the destination vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Union(AMX* amx, cell* params)
+{
+	return SetOperationNative(amx, params, SET_UNION);
+}
+
+/// <summary>
+/// Stores the elements which are in both vectors.
+/// </summary>
+/// <param name="amx"> Vector_Intersect </param>
+/// <param name="params"> vectorA, vectorB, destination </param>
+/// <returns> The size of the destination vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Intersect(AMX* amx, cell* params)
+{
+	return SetOperationNative(amx, params, SET_INTERSECTION);
+}
+
+/// <summary>
+/// Stores the elements of the first vector which aren't in the second one.
+/// </summary>
+/// <param name="amx"> Vector_Difference </param>
+/// <param name="params"> vectorA, vectorB, destination </param>
+/// <returns> The size of the destination vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Difference(AMX* amx, cell* params)
+{
+	return SetOperationNative(amx, params, SET_DIFFERENCE);
+}
+
+/// <summary>
+/// Finds the first element which isn't less than the given value in a sorted vector.
+/// It's also the number of elements less than the value (its rank).
+/// </summary>
+/// <param name="amx"> Vector_LowerBound </param>
+/// <param name="params"> vectorID, value </param>
+/// <returns> The index of the element, or the size of the vector if there is no such element. -1 if the vector isn't sorted. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_LowerBound(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || !vector->IsOrdered())
+		return -1;
+
+	auto index = vector->LowerBound(vector->ToKey(params[2]));
+	TRACE("Vector_LowerBound", "Returning the index %d for vector %d, given value %d.", static_cast<int>(index), static_cast<int>(params[1]), static_cast<int>(params[2]));
+	return static_cast<cell>(index);
+}
+
+/// <summary>
+/// Finds the first element which is greater than the given value in a sorted vector.
+/// </summary>
+/// <param name="amx"> Vector_UpperBound </param>
+/// <param name="params"> vectorID, value </param>
+/// <returns> The index of the element, or the size of the vector if there is no such element. -1 if the vector isn't sorted. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_UpperBound(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL || !vector->IsOrdered())
+		return -1;
+
+	auto index = vector->UpperBound(vector->ToKey(params[2]));
+	TRACE("Vector_UpperBound", "Returning the index %d for vector %d, given value %d.", static_cast<int>(index), static_cast<int>(params[1]), static_cast<int>(params[2]));
+	return static_cast<cell>(index);
+}
+
+/// <summary>
+/// Counts the elements between lo and hi, inclusive.
+/// </summary>
+/// <param name="amx"> Vector_CountInRange </param>
+/// <param name="params"> vectorID, lo, hi </param>
+/// <returns> The number of elements in range. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_CountInRange(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	auto count = vector->CountInRange(vector->ToKey(params[2]), vector->ToKey(params[3]));
+	TRACE("Vector_CountInRange", "Found %d elements between %d and %d in vector %d.", static_cast<int>(count), static_cast<int>(params[2]), static_cast<int>(params[3]), static_cast<int>(params[1]));
+	return static_cast<cell>(count);
+}
+
+/// <summary>
+/// Adds up the elements of the vector. Like adding in Pawn, a sum beyond the cell range wraps around.
+/// </summary>
+/// <param name="amx"> Vector_Sum </param>
+/// <param name="params"> vectorID </param>
+/// <returns> The sum of the elements (a Float for a Float vector), 0 for an empty vector or a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Sum(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	// The elements of a string vector are pool IDs, they add up to nothing meaningful.
+	if (vector->Type() == DenseSet::ELEMENT_STRING)
+		return 0;
+
+	if (vector->Type() == DenseSet::ELEMENT_FLOAT) {
+		const double sum = vector->FloatSum();
+		TRACE("Vector_Sum", "The sum of the %d elements of vector %d is %f.", static_cast<int>(vector->Size()), static_cast<int>(params[1]), sum);
+		return FloatToCell(static_cast<float>(sum));
+	}
+	const int64_t sum = vector->Sum();
+	TRACE("Vector_Sum", "The sum of the %d elements of vector %d is %lld.", static_cast<int>(vector->Size()), static_cast<int>(params[1]), static_cast<long long>(sum));
+	return static_cast<cell>(static_cast<uint32_t>(static_cast<uint64_t>(sum)));
+}
+
+/// <summary>
+/// Returns the smallest element of the vector.
+/// </summary>
+/// <param name="amx"> Vector_Min </param>
+/// <param name="params"> vectorID </param>
+/// <returns> The smallest element, 0 for an empty vector or a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Min(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	if (vector->Type() == DenseSet::ELEMENT_STRING)
+		return 0;
+
+	int min, max;
+	if (!vector->MinMax(min, max))
+		return 0;
+	TRACE("Vector_Min", "Returning the value %d for vector %d.", min, static_cast<int>(params[1]));
+	return static_cast<cell>(vector->ToValue(min));
+}
+
+/// <summary>
+/// Returns the largest element of the vector.
+/// </summary>
+/// <param name="amx"> Vector_Max </param>
+/// <param name="params"> vectorID </param>
+/// <returns> The largest element, 0 for an empty vector or a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Max(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	if (vector->Type() == DenseSet::ELEMENT_STRING)
+		return 0;
+
+	int min, max;
+	if (!vector->MinMax(min, max))
+		return 0;
+	TRACE("Vector_Max", "Returning the value %d for vector %d.", max, static_cast<int>(params[1]));
+	return static_cast<cell>(vector->ToValue(max));
+}
+
+/// <summary>
+/// Returns the mean of the elements of the vector.
+/// </summary>
+/// <param name="amx"> Vector_Average </param>
+/// <param name="params"> vectorID </param>
+/// <returns> The mean as a Float, 0.0 for an empty vector or a string vector. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Average(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	if (vector->Type() == DenseSet::ELEMENT_STRING)
+		return 0;
+	if (vector->Empty())
+		return FloatToCell(0.0f);
+
+	const double sum = (vector->Type() == DenseSet::ELEMENT_FLOAT) ? vector->FloatSum() : static_cast<double>(vector->Sum());
+	const double average = sum / static_cast<double>(vector->Size());
+	TRACE("Vector_Average", "The average of vector %d is %f.", static_cast<int>(params[1]), average);
+	return FloatToCell(static_cast<float>(average));
+}
+
+/// <summary>
+/// Returns the type of the elements of the vector.
+/// </summary>
+/// <param name="amx"> Vector_GetType </param>
+/// <param name="params"> vectorID </param>
+/// <returns> VECTOR_INT, VECTOR_FLOAT, VECTOR_STRING or VECTOR_RECORD </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_GetType(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const VectorObject *vector = vectors.Get(params[1]);
+	if (vector == NULL)
+		return -1;
+	if (vector->HoldsRecords()) {
+		TRACE("Vector_GetType", "Vector %d holds records of %d fields.", static_cast<int>(params[1]), static_cast<int>(vector->records.Fields()));
+		return VECTOR_RECORD_TYPE;
+	}
+
+	static const char *const type_names[] = { "int", "Float", "string" };
+	TRACE("Vector_GetType", "Vector %d holds %s elements.", static_cast<int>(params[1]), type_names[vector->set.Type()]);
+	return static_cast<cell>(vector->set.Type());
+}
+
+/// <summary>
+/// Keeps the sum, minimum and maximum of the vector up to date on every change, so reading them doesn't scan the elements.
+/// </summary>
+/// <param name="amx"> Vector_TrackAggregates </param>
+/// <param name="params"> vectorID, toggle </param>
+/// <returns> 1 </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_TrackAggregates(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	const bool toggle = params[2] != 0;
+	vector->TrackAggregates(toggle);
+	TRACE("Vector_TrackAggregates", "%s the aggregates of vector %d.", toggle ? "Tracking" : "No longer tracking", static_cast<int>(params[1]));
+	return 1;
+}
+
+// Orders the IDs of a string vector by their text.
+struct CompareStrings
+{
+	bool descending;
+
+	bool operator()(int a, int b) const
+	{
+		const char *text_a = stringpool::Get(a), *text_b = stringpool::Get(b);
+		const int order = strcmp(text_a != NULL ? text_a : "", text_b != NULL ? text_b : "");
+		return descending ? (order > 0) : (order < 0);
+	}
+};
+
+/// <summary>
+/// Sorts the elements of the vector, string vectors in alphabetical order.
+/// </summary>
+/// <param name="amx"> Vector_Sort </param>
+/// <param name="params"> vectorID, descending </param>
+/// <returns> 1 if vector has been sorted, 0 if it's a sorted vector and descending order was requested </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_Sort(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+
+	bool descending = static_cast<bool>(params[2]);
+	if (vector->IsOrdered() && !descending)
+		return 1;
+	bool sorted;
+	if (vector->Type() == DenseSet::ELEMENT_STRING) {
+		CompareStrings compare;
+		compare.descending = descending;
+		sorted = vector->Sort(compare);
+	}
+	else
+		sorted = descending ? vector->Sort(std::greater<int>()) : vector->Sort(std::less<int>());
+	TRACE("Vector_Sort", "Sorting %d elements of vector %d in %s order.", static_cast<int>(vector->Size()), static_cast<int>(params[1]), descending ? "descending" : "ascending");
+	return sorted;
+}
+
+// Orders elements by the values found at their positions in an array,
+// elements out of the array's bounds go after all the others.
+struct CompareByKey
+{
+	const cell *keys;
+	size_t num_keys;
+	bool descending;
+
+	bool operator()(int a, int b) const
+	{
+		const bool a_valid = static_cast<unsigned int>(a) < num_keys, b_valid = static_cast<unsigned int>(b) < num_keys;
+		if (!a_valid || !b_valid)
+			return a_valid && !b_valid;
+		return descending ? (keys[a] > keys[b]) : (keys[a] < keys[b]);
+	}
+};
+
+/// <summary>
+/// Sorts the elements of the vector by the values of a parallel array.
+/// </summary>
+/// <param name="amx"> Vector_SortByKey </param>
+/// <param name="params"> vectorID, const keys[], keys_len, descending </param>
+/// <returns> 1 if vector has been sorted, 0 if it's a sorted vector or doesn't hold ints </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_SortByKey(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseSet *vector = GetVector(params[1]);
+	if (vector == NULL)
+		return -1;
+	// The elements index the array, the keys of Floats and strings aren't positions.
+	if (vector->Type() != DenseSet::ELEMENT_INT)
+		return 0;
+
+	cell *keys;
+	if (amx_GetAddr(amx, params[2], &keys) != AMX_ERR_NONE)
+		return 0;
+
+	CompareByKey compare;
+	compare.keys = keys;
+	compare.num_keys = params[3] > 0 ? static_cast<size_t>(params[3]) : 0;
+	compare.descending = static_cast<bool>(params[4]);
+
+	TRACE("Vector_SortByKey", "Sorting %d elements of vector %d by key in %s order.", static_cast<int>(vector->Size()), static_cast<int>(params[1]), compare.descending ? "descending" : "ascending");
+	return vector->Sort(compare);
+}
+
+/// <summary>
+/// Creating a vector of records, each one made of the given number of cells like a row of a Pawn enum array.
+/// The vector is destroyed when the script which created it is unloaded.
+/// </summary>
+/// <param name="amx"> Vector_CreateRecords </param>
+/// <param name="params"> fields </param>
+/// <returns> vectorID, or 0 if the number of fields is out of range or no more vectors can be created </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_CreateRecords(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	if (params[1] <= 0 || params[1] > MAX_RECORD_FIELDS) {
+		logprintf("%s: %s: Records need between 1 and %d fields, %d given.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(MAX_RECORD_FIELDS), static_cast<int>(params[1]));
+		return 0;
+	}
+
+	VectorObject object;
+	RecordTable(static_cast<size_t>(params[1])).Swap(object.records);
+	cell vectorID = AddVector(amx, amx, object);
+	if (vectorID != 0) TRACE("Vector_CreateRecords", "A new vector of %d field records has been created with ID: %d.", static_cast<int>(params[1]), static_cast<int>(vectorID));
+	return vectorID;
+}
+
+/// <summary>
+/// Appends a record copied from an array. Missing fields are set to 0, extra cells are ignored.
+/// </summary>
+/// <param name="amx"> Vector_AddRecord </param>
+/// <param name="params"> vectorID, const record[], len </param>
+/// <returns> The index of the new record, -1 if the vector doesn't exist or doesn't hold records </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_AddRecord(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+
+	cell *record;
+	if (amx_GetAddr(amx, params[2], &record) != AMX_ERR_NONE)
+		return -1;
+
+	const size_t index = records->Append(record, params[3] > 0 ? static_cast<size_t>(params[3]) : 0);
+	TRACE("Vector_AddRecord", "Added a record at index %d of vector %d.", static_cast<int>(index), static_cast<int>(params[1]));
+	return ClampToCell(index);
+}
+
+/// <summary>
+/// Copies a record into an array.
+/// </summary>
+/// <param name="amx"> Vector_GetRecord </param>
+/// <param name="params"> vectorID, index, dest[], maxlen </param>
+/// <returns> The number of cells copied, 0 if the index is out of range, -1 if the vector doesn't exist or doesn't hold records </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_GetRecord(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Size() || params[4] <= 0)
+		return 0;
+
+	cell *dest;
+	if (amx_GetAddr(amx, params[3], &dest) != AMX_ERR_NONE)
+		return 0;
+
+	const size_t copied = records->Copy(static_cast<size_t>(params[2]), dest, static_cast<size_t>(params[4]));
+	TRACE("Vector_GetRecord", "Copied %d fields of record %d of vector %d.", static_cast<int>(copied), static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return static_cast<cell>(copied);
+}
+
+/// <summary>
+/// Overwrites a record with the cells of an array. Missing fields are set to 0, extra cells are ignored.
+/// </summary>
+/// <param name="amx"> Vector_SetRecord </param>
+/// <param name="params"> vectorID, index, const record[], len </param>
+/// <returns> 1 if the record has been overwritten, 0 if the index is out of range </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_SetRecord(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Size())
+		return 0;
+
+	cell *record;
+	if (amx_GetAddr(amx, params[3], &record) != AMX_ERR_NONE)
+		return 0;
+
+	records->Assign(static_cast<size_t>(params[2]), record, params[4] > 0 ? static_cast<size_t>(params[4]) : 0);
+	TRACE("Vector_SetRecord", "Overwrote record %d of vector %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Reads one field of a record.
+/// </summary>
+/// <param name="amx"> Vector_GetField </param>
+/// <param name="params"> vectorID, index, field </param>
+/// <returns> The value of the field. If it doesn't exist, it returns -1. </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_GetField(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Size() || params[3] < 0 || static_cast<size_t>(params[3]) >= records->Fields())
+		return -1;
+
+	const int value = records->Field(static_cast<size_t>(params[2]), static_cast<size_t>(params[3]));
+	TRACE("Vector_GetField", "Returning the value %d of field %d of record %d of vector %d.", value, static_cast<int>(params[3]), static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return static_cast<cell>(value);
+}
+
+/// <summary>
+/// Overwrites one field of a record.
+/// </summary>
+/// <param name="amx"> Vector_SetField </param>
+/// <param name="params"> vectorID, index, field, value </param>
+/// <returns> 1 if the field has been set, 0 if the index or the field is out of range </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_SetField(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Size() || params[3] < 0 || static_cast<size_t>(params[3]) >= records->Fields())
+		return 0;
+
+	records->SetField(static_cast<size_t>(params[2]), static_cast<size_t>(params[3]), params[4]);
+	TRACE("Vector_SetField", "Set field %d of record %d of vector %d to %d.", static_cast<int>(params[3]), static_cast<int>(params[2]), static_cast<int>(params[1]), static_cast<int>(params[4]));
+	return 1;
+}
+
+/// <summary>
+/// Finds the first record, from the given index on, whose field holds the value. Only that field is scanned.
+/// </summary>
+/// <param name="amx"> Vector_FindRecord </param>
+/// <param name="params"> vectorID, field, value, start </param>
+/// <returns> The index of the record, or -1 if there is none </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_FindRecord(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Fields() || params[4] < 0)
+		return -1;
+
+	const int index = records->Find(static_cast<size_t>(params[2]), params[3], static_cast<size_t>(params[4]));
+	TRACE("Vector_FindRecord", "Returning the index %d for vector %d after searching field %d for %d.", index, static_cast<int>(params[1]), static_cast<int>(params[2]), static_cast<int>(params[3]));
+	return static_cast<cell>(index);
+}
+
+/// <summary>
+/// Sorts the records on one of their fields, records with equal fields keep their order.
+/// The field is compared as ints unless is_float is set, in which case it is compared as Floats.
+/// </summary>
+/// <param name="amx"> Vector_SortRecords </param>
+/// <param name="params"> vectorID, field, descending, is_float </param>
+/// <returns> 1 if the records have been sorted, 0 if the field is out of range </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_SortRecords(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Fields())
+		return 0;
+
+	TRACE("Vector_SortRecords", "Sorting %d records of vector %d on %s field %d in %s order.", static_cast<int>(records->Size()), static_cast<int>(params[1]), params[4] ? "Float" : "int", static_cast<int>(params[2]), params[3] ? "descending" : "ascending");
+	records->Sort(static_cast<size_t>(params[2]), params[3] != 0, params[4] != 0);
+	return 1;
+}
+
+/// <summary>
+/// Deletes a record. The last record of the vector takes its place.
+/// </summary>
+/// <param name="amx"> Vector_DeleteRecord </param>
+/// <param name="params"> vectorID, index </param>
+/// <returns> 1 if the record has been deleted, 0 if the index is out of range </returns>
+
+static cell AMX_NATIVE_CALL n_Vector_DeleteRecord(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	RecordTable *records = GetRecords(params[1]);
+	if (records == NULL)
+		return -1;
+	if (params[2] < 0 || static_cast<size_t>(params[2]) >= records->Size())
+		return 0;
+
+	TRACE("Vector_DeleteRecord", "Deleting record %d of vector %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+	records->EraseAt(static_cast<size_t>(params[2]));
+	return 1;
+}
+
+/// <summary>
+/// Creating a map of int keys to int or array values. The map is destroyed when the script which created it is unloaded.
+/// </summary>
+/// <param name="amx"> Map_Create </param>
+/// <param name="params"> </param>
+/// <returns> mapID, or 0 if no more maps can be created </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Create(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 0;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	DenseMap map;
+	const cell mapID = maps.Create(amx, map);
+	if (mapID == 0) {
+		logprintf("%s: %s: The limit of %d maps has been reached.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(HANDLE_SLOT_MASK));
+		return 0;
+	}
+	TRACE("Map_Create", "Created map %d.", static_cast<int>(mapID));
+	return mapID;
+}
+
+/// <summary>
+/// Destroys the map, its handle becomes invalid.
+/// </summary>
+/// <param name="amx"> Map_Destroy </param>
+/// <param name="params"> mapID </param>
+/// <returns> 1 if the map has been destroyed, -1 if the map doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Destroy(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	TRACE("Map_Destroy", "Destroying map %d with %d entries.", static_cast<int>(params[1]), static_cast<int>(map->Size()));
+	maps.Destroy(HandleTable<DenseMap>::SlotOf(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Returns the number of keys in the map.
+/// </summary>
+/// <param name="amx"> Map_Size </param>
+/// <param name="params"> mapID </param>
+/// <returns> The size of the map, -1 if the map doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Size(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	return ClampToCell(map->Size());
+}
+
+/// <summary>
+/// Removes all the keys from the map.
+/// </summary>
+/// <param name="amx"> Map_Clear </param>
+/// <param name="params"> mapID </param>
+/// <returns> 1 if the map had keys, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Clear(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+	if (map->Empty())
+		return 0;
+
+	TRACE("Map_Clear", "Clearing %d entries from map %d.", static_cast<int>(map->Size()), static_cast<int>(params[1]));
+	map->Clear();
+	return 1;
+}
+
+/// <summary>
+/// Sets the value of a key, replacing its previous value or array.
+/// </summary>
+/// <param name="amx"> Map_Set </param>
+/// <param name="params"> mapID, key, value </param>
+/// <returns> 1 if the key is new, 0 if its value has been replaced </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Set(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	TRACE("Map_Set", "Setting key %d of map %d to %d.", static_cast<int>(params[2]), static_cast<int>(params[1]), static_cast<int>(params[3]));
+	return map->Set(params[2], params[3]);
+}
+
+/// <summary>
+/// Reads the int value of a key, a key holding an array is read with Map_GetArray.
+/// </summary>
+/// <param name="amx"> Map_Get </param>
+/// <param name="params"> mapID, key, &value </param>
+/// <returns> 1 and stores the value, 0 if the key isn't in the map or holds an array, -1 if the map doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Get(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	const int index = map->IndexOf(params[2]);
+	if (index == -1 || map->ArrayAt(static_cast<size_t>(index)) != NULL)
+		return 0;
+
+	cell *value;
+	if (amx_GetAddr(amx, params[3], &value) != AMX_ERR_NONE)
+		return 0;
+
+	*value = static_cast<cell>(map->ValueAt(static_cast<size_t>(index)));
+	TRACE("Map_Get", "Returning the value %d of key %d of map %d.", static_cast<int>(*value), static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Checks if the key is in the map.
+/// </summary>
+/// <param name="amx"> Map_Contains </param>
+/// <param name="params"> mapID, key </param>
+/// <returns> 1 if the key is in the map, 0 if it isn't, -1 if the map doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Contains(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	return map->IndexOf(params[2]) != -1;
+}
+
+/// <summary>
+/// Removes the key from the map. The last entry takes its place.
+/// </summary>
+/// <param name="amx"> Map_Remove </param>
+/// <param name="params"> mapID, key </param>
+/// <returns> 1 if the key has been removed, 0 if it isn't in the map </returns>
+
+static cell AMX_NATIVE_CALL n_Map_Remove(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	TRACE("Map_Remove", "Removing key %d from map %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return map->Erase(params[2]);
+}
+
+/// <summary>
+/// Stores a copy of an array as the value of a key, replacing its previous value or array.
+/// </summary>
+/// <param name="amx"> Map_SetArray </param>
+/// <param name="params"> mapID, key, const src[], len </param>
+/// <returns> 1 if the key is new, 0 if its value has been replaced </returns>
+
+static cell AMX_NATIVE_CALL n_Map_SetArray(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	cell *src;
+	if (amx_GetAddr(amx, params[3], &src) != AMX_ERR_NONE)
+		return 0;
+
+	const size_t count = params[4] > 0 ? static_cast<size_t>(params[4]) : 0;
+	TRACE("Map_SetArray", "Setting key %d of map %d to an array of %d cells.", static_cast<int>(params[2]), static_cast<int>(params[1]), static_cast<int>(count));
+	return map->SetArray(params[2], src, count);
+}
+
+/// <summary>
+/// Copies the array stored for a key. A key holding an int copies no cells.
+/// </summary>
+/// <param name="amx"> Map_GetArray </param>
+/// <param name="params"> mapID, key, dest[], maxlen </param>
+/// <returns> The number of cells copied, -1 if the key isn't in the map </returns>
+
+static cell AMX_NATIVE_CALL n_Map_GetArray(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	const int index = map->IndexOf(params[2]);
+	if (index == -1)
+		return -1;
+
+	const int *array = map->ArrayAt(static_cast<size_t>(index));
+	if (array == NULL || params[4] <= 0)
+		return 0;
+
+	cell *dest;
+	if (amx_GetAddr(amx, params[3], &dest) != AMX_ERR_NONE)
+		return 0;
+
+	const size_t count = std::min(static_cast<size_t>(map->ValueAt(static_cast<size_t>(index))), static_cast<size_t>(params[4]));
+	std::copy(array, array + count, dest);
+	TRACE("Map_GetArray", "Copied %d cells of key %d of map %d.", static_cast<int>(count), static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return static_cast<cell>(count);
+}
+
+/// <summary>
+/// Advances an iteration over the map, the cursor starts at 0.
+/// </summary>
+/// <param name="amx"> Map_IterNext </param>
+/// <param name="params"> mapID, &cursor, &key, &value </param>
+/// <returns> 1 and stores the next key and its value (the length of its array for a key holding one), or 0 when the end of the map has been reached. </returns>
+
+static cell AMX_NATIVE_CALL n_Map_IterNext(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 4;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return 0;
+
+	cell *cursor, *key, *value;
+	if (amx_GetAddr(amx, params[2], &cursor) != AMX_ERR_NONE || amx_GetAddr(amx, params[3], &key) != AMX_ERR_NONE ||
+		amx_GetAddr(amx, params[4], &value) != AMX_ERR_NONE)
+		return 0;
+
+	if (*cursor < 0 || static_cast<size_t>(*cursor) >= map->Size())
+		return 0;
+
+	*key = static_cast<cell>(map->KeyAt(static_cast<size_t>(*cursor)));
+	*value = static_cast<cell>(map->ValueAt(static_cast<size_t>(*cursor)));
+	++*cursor;
+	return 1;
+}
+
+/// <summary>
+/// Removes the key returned by the last Map_IterNext call.
+/// The last entry of the map takes its place and will be returned by the next Map_IterNext call.
+/// </summary>
+/// <param name="amx"> Map_IterRemove </param>
+/// <param name="params"> mapID, &cursor </param>
+/// <returns> 1 if the key has been removed, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Map_IterRemove(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseMap *map = GetMap(params[1]);
+	if (map == NULL)
+		return -1;
+
+	cell *cursor;
+	if (amx_GetAddr(amx, params[2], &cursor) != AMX_ERR_NONE)
+		return 0;
+
+	if (*cursor < 1 || static_cast<size_t>(*cursor) > map->Size())
+		return 0;
+
+	--*cursor;
+	TRACE("Map_IterRemove", "Removed key %d from map %d while iterating.", map->KeyAt(*cursor), static_cast<int>(params[1]));
+	map->EraseAt(static_cast<size_t>(*cursor));
+	return 1;
+}
+
+/// <summary>
+/// Creating a priority queue of unique int values ordered by an int priority, the lowest priority first.
+/// The queue is destroyed when the script which created it is unloaded.
+/// </summary>
+/// <param name="amx"> Heap_Create </param>
+/// <param name="params"> </param>
+/// <returns> heapID, or 0 if no more queues can be created </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Create(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 0;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+
+	DenseHeap heap;
+	const cell heapID = heaps.Create(amx, heap);
+	if (heapID == 0) {
+		logprintf("%s: %s: The limit of %d queues has been reached.", PLUGIN_NAME, pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(HANDLE_SLOT_MASK));
+		return 0;
+	}
+	TRACE("Heap_Create", "Created queue %d.", static_cast<int>(heapID));
+	return heapID;
+}
+
+/// <summary>
+/// Destroys the queue, its handle becomes invalid.
+/// </summary>
+/// <param name="amx"> Heap_Destroy </param>
+/// <param name="params"> heapID </param>
+/// <returns> 1 if the queue has been destroyed, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Destroy(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	TRACE("Heap_Destroy", "Destroying queue %d with %d values.", static_cast<int>(params[1]), static_cast<int>(heap->Size()));
+	heaps.Destroy(HandleTable<DenseHeap>::SlotOf(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Returns the number of values in the queue.
+/// </summary>
+/// <param name="amx"> Heap_Size </param>
+/// <param name="params"> heapID </param>
+/// <returns> The size of the queue, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Size(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	return ClampToCell(heap->Size());
+}
+
+/// <summary>
+/// Removes all the values from the queue.
+/// </summary>
+/// <param name="amx"> Heap_Clear </param>
+/// <param name="params"> heapID </param>
+/// <returns> 1 if the queue had values, otherwise returns 0 </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Clear(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 1;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+	if (heap->Empty())
+		return 0;
+
+	TRACE("Heap_Clear", "Clearing %d values from queue %d.", static_cast<int>(heap->Size()), static_cast<int>(params[1]));
+	heap->Clear();
+	return 1;
+}
+
+/// <summary>
+/// Queues a value with the given priority, or changes the priority of a value already queued. O(log n).
+/// </summary>
+/// <param name="amx"> Heap_Push </param>
+/// <param name="params"> heapID, value, priority </param>
+/// <returns> 1 if the value is new, 0 if its priority has been changed </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Push(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	TRACE("Heap_Push", "Queueing value %d with priority %d in queue %d.", static_cast<int>(params[2]), static_cast<int>(params[3]), static_cast<int>(params[1]));
+	return heap->Push(params[2], params[3]);
+}
+
+/// <summary>
+/// Reads the value of lowest priority without removing it. O(1).
+/// </summary>
+/// <param name="amx"> Heap_Peek </param>
+/// <param name="params"> heapID, &value, &priority </param>
+/// <returns> 1 and stores the value and its priority, 0 if the queue is empty, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Peek(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+	if (heap->Empty())
+		return 0;
+
+	cell *value, *priority;
+	if (amx_GetAddr(amx, params[2], &value) != AMX_ERR_NONE || amx_GetAddr(amx, params[3], &priority) != AMX_ERR_NONE)
+		return 0;
+
+	*value = static_cast<cell>(heap->Top());
+	*priority = static_cast<cell>(heap->TopPriority());
+	TRACE("Heap_Peek", "Returning the value %d with priority %d from queue %d.", static_cast<int>(*value), static_cast<int>(*priority), static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Removes the value of lowest priority. O(log n).
+/// </summary>
+/// <param name="amx"> Heap_Pop </param>
+/// <param name="params"> heapID, &value, &priority </param>
+/// <returns> 1 and stores the value and its priority, 0 if the queue is empty, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Pop(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+	if (heap->Empty())
+		return 0;
+
+	cell *value, *priority;
+	if (amx_GetAddr(amx, params[2], &value) != AMX_ERR_NONE || amx_GetAddr(amx, params[3], &priority) != AMX_ERR_NONE)
+		return 0;
+
+	*value = static_cast<cell>(heap->Top());
+	*priority = static_cast<cell>(heap->TopPriority());
+	heap->Pop();
+	TRACE("Heap_Pop", "Removed the value %d with priority %d from queue %d.", static_cast<int>(*value), static_cast<int>(*priority), static_cast<int>(params[1]));
+	return 1;
+}
+
+/// <summary>
+/// Lowers the priority of a queued value. O(log n).
+/// </summary>
+/// <param name="amx"> Heap_DecreaseKey </param>
+/// <param name="params"> heapID, value, priority </param>
+/// <returns> 1 if the priority has been lowered, 0 if the value isn't queued or its priority is already lower or equal </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_DecreaseKey(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	TRACE("Heap_DecreaseKey", "Lowering the priority of value %d to %d in queue %d.", static_cast<int>(params[2]), static_cast<int>(params[3]), static_cast<int>(params[1]));
+	return heap->DecreaseKey(params[2], params[3]);
+}
+
+/// <summary>
+/// Removes a value from the queue, wherever it is. O(log n).
+/// </summary>
+/// <param name="amx"> Heap_Remove </param>
+/// <param name="params"> heapID, value </param>
+/// <returns> 1 if the value has been removed, 0 if it isn't queued </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Remove(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	TRACE("Heap_Remove", "Removing value %d from queue %d.", static_cast<int>(params[2]), static_cast<int>(params[1]));
+	return heap->Erase(params[2]);
+}
+
+/// <summary>
+/// Checks if the value is queued.
+/// </summary>
+/// <param name="amx"> Heap_Contains </param>
+/// <param name="params"> heapID, value </param>
+/// <returns> 1 if the value is queued, 0 if it isn't, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_Contains(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 2;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	return heap->Contains(params[2]);
+}
+
+/// <summary>
+/// Reads the priority of a queued value.
+/// </summary>
+/// <param name="amx"> Heap_GetPriority </param>
+/// <param name="params"> heapID, value, &priority </param>
+/// <returns> 1 and stores the priority, 0 if the value isn't queued, -1 if the queue doesn't exist </returns>
+
+static cell AMX_NATIVE_CALL n_Heap_GetPriority(AMX* amx, cell* params)
+{
+	unsigned short int num_args = 3;
+	if (!pluginutils::CheckNumberOfArguments(amx, params, num_args))
+		return 0;
+	const DenseHeap *heap = GetHeap(params[1]);
+	if (heap == NULL)
+		return -1;
+
+	int found;
+	if (!heap->PriorityOf(params[2], found))
+		return 0;
+
+	cell *priority;
+	if (amx_GetAddr(amx, params[3], &priority) != AMX_ERR_NONE)
+		return 0;
 
-	if (debugging) logprintf("%s: Replacing value %d with %d in vector %d with index %d.", pluginutils::GetCurrentNativeFunctionName(amx), static_cast<int>(params[2]), static_cast<unsigned long int>(params[3]), vectorID + 1, index);
+	*priority = static_cast<cell>(found);
 	return 1;
 }
 
 static AMX_NATIVE_INFO plugin_natives[] =
 {
-	{ "Vector_Create", n_Vector_Create },
-	{ "Vector_DebugMode", n_Vector_DebugMode },
-	{ "Vector_Size", n_Vector_Size },
-	{ "Vector_Odd", n_Vector_Odd },
-	{ "Vector_Even", n_Vector_Even },
-	{ "Vector_Empty", n_Vector_Empty },
-	{ "Vector_Add", n_Vector_Add },
-	{ "Vector_Clear", n_Vector_Clear },
-	{ "Vector_Remove", n_Vector_Remove },
-	{ "Vector_Delete", n_Vector_Delete },
-	{ "Vector_Begin", n_Vector_Begin },
-	{ "Vector_End", n_Vector_End },
-	{ "Vector_First", n_Vector_First },
-	{ "Vector_Last", n_Vector_Last },
-	{ "Vector_Next", n_Vector_Next },
-	{ "Vector_Prev", n_Vector_Prev },
-	{ "Vector_Random", n_Vector_Random },
-	{ "Vector_PopBack", n_Vector_PopBack },
-	{ "Vector_PopFront", n_Vector_PopFront },
-	{ "Vector_FindIndex", n_Vector_FindIndex },
-	{ "Vector_FindValue", n_Vector_FindValue },
-	{ "Vector_ReplaceIndex", n_Vector_ReplaceIndex },
-	{ "Vector_Replace", n_Vector_Replace }
+	{ "Vector_Create", stats::Measured<n_Vector_Create> },
+	{ "Vector_CreateSorted", stats::Measured<n_Vector_CreateSorted> },
+	{ "Vector_CreateShared", stats::Measured<n_Vector_CreateShared> },
+	{ "Vector_FindShared", stats::Measured<n_Vector_FindShared> },
+	{ "Vector_Destroy", stats::Measured<n_Vector_Destroy> },
+	{ "Vector_GetType", stats::Measured<n_Vector_GetType> },
+	{ "Vector_DebugMode", stats::Measured<n_Vector_DebugMode> },
+	{ "Vector_TraceNative", stats::Measured<n_Vector_TraceNative> },
+	{ "Vector_GetStats", stats::Measured<n_Vector_GetStats> },
+	{ "Vector_DumpStats", stats::Measured<n_Vector_DumpStats> },
+	{ "Vector_ResetStats", stats::Measured<n_Vector_ResetStats> },
+	{ "Vector_Size", stats::Measured<n_Vector_Size> },
+	{ "Vector_Odd", stats::Measured<n_Vector_Odd> },
+	{ "Vector_Even", stats::Measured<n_Vector_Even> },
+	{ "Vector_Empty", stats::Measured<n_Vector_Empty> },
+	{ "Vector_Reserve", stats::Measured<n_Vector_Reserve> },
+	{ "Vector_ShrinkToFit", stats::Measured<n_Vector_ShrinkToFit> },
+	{ "Vector_Capacity", stats::Measured<n_Vector_Capacity> },
+	{ "Vector_MemoryUsage", stats::Measured<n_Vector_MemoryUsage> },
+	{ "Vector_PoolStats", stats::Measured<n_Vector_PoolStats> },
+	{ "Vector_Add", stats::Measured<n_Vector_Add> },
+	{ "Vector_Clear", stats::Measured<n_Vector_Clear> },
+	{ "Vector_Remove", stats::Measured<n_Vector_Remove> },
+	{ "Vector_Delete", stats::Measured<n_Vector_Delete> },
+	{ "Vector_Begin", stats::Measured<n_Vector_Begin> },
+	{ "Vector_End", stats::Measured<n_Vector_End> },
+	{ "Vector_First", stats::Measured<n_Vector_First> },
+	{ "Vector_Last", stats::Measured<n_Vector_Last> },
+	{ "Vector_Next", stats::Measured<n_Vector_Next> },
+	{ "Vector_Prev", stats::Measured<n_Vector_Prev> },
+	{ "Vector_Random", stats::Measured<n_Vector_Random> },
+	{ "Vector_PopBack", stats::Measured<n_Vector_PopBack> },
+	{ "Vector_PopFront", stats::Measured<n_Vector_PopFront> },
+	{ "Vector_FindIndex", stats::Measured<n_Vector_FindIndex> },
+	{ "Vector_FindValue", stats::Measured<n_Vector_FindValue> },
+	{ "Vector_IterBegin", stats::Measured<n_Vector_IterBegin> },
+	{ "Vector_IterNext", stats::Measured<n_Vector_IterNext> },
+	{ "Vector_IterRemove", stats::Measured<n_Vector_IterRemove> },
+	{ "Vector_ToArray", stats::Measured<n_Vector_ToArray> },
+	{ "Vector_AddArray", stats::Measured<n_Vector_AddArray> },
+	{ "Vector_Assign", stats::Measured<n_Vector_Assign> },
+	{ "Vector_Batch", stats::Measured<n_Vector_Batch> },
+	{ "Vector_AddString", stats::Measured<n_Vector_AddString> },
+	{ "Vector_GetString", stats::Measured<n_Vector_GetString> },
+	{ "Vector_FindString", stats::Measured<n_Vector_FindString> },
+	{ "Vector_Union", stats::Measured<n_Vector_Union> },
+	{ "Vector_Intersect", stats::Measured<n_Vector_Intersect> },
+	{ "Vector_Difference", stats::Measured<n_Vector_Difference> },
+	{ "Vector_LowerBound", stats::Measured<n_Vector_LowerBound> },
+	{ "Vector_UpperBound", stats::Measured<n_Vector_UpperBound> },
+	{ "Vector_CountInRange", stats::Measured<n_Vector_CountInRange> },
+	{ "Vector_Sum", stats::Measured<n_Vector_Sum> },
+	{ "Vector_Min", stats::Measured<n_Vector_Min> },
+	{ "Vector_Max", stats::Measured<n_Vector_Max> },
+	{ "Vector_Average", stats::Measured<n_Vector_Average> },
+	{ "Vector_TrackAggregates", stats::Measured<n_Vector_TrackAggregates> },
+	{ "Vector_Sort", stats::Measured<n_Vector_Sort> },
+	{ "Vector_SortByKey", stats::Measured<n_Vector_SortByKey> },
+	{ "Vector_ReplaceIndex", stats::Measured<n_Vector_ReplaceIndex> },
+	{ "Vector_Replace", stats::Measured<n_Vector_Replace> },
+	{ "Vector_CreateRecords", stats::Measured<n_Vector_CreateRecords> },
+	{ "Vector_AddRecord", stats::Measured<n_Vector_AddRecord> },
+	{ "Vector_GetRecord", stats::Measured<n_Vector_GetRecord> },
+	{ "Vector_SetRecord", stats::Measured<n_Vector_SetRecord> },
+	{ "Vector_GetField", stats::Measured<n_Vector_GetField> },
+	{ "Vector_SetField", stats::Measured<n_Vector_SetField> },
+	{ "Vector_FindRecord", stats::Measured<n_Vector_FindRecord> },
+	{ "Vector_SortRecords", stats::Measured<n_Vector_SortRecords> },
+	{ "Vector_DeleteRecord", stats::Measured<n_Vector_DeleteRecord> },
+	{ "Map_Create", stats::Measured<n_Map_Create> },
+	{ "Map_Destroy", stats::Measured<n_Map_Destroy> },
+	{ "Map_Size", stats::Measured<n_Map_Size> },
+	{ "Map_Clear", stats::Measured<n_Map_Clear> },
+	{ "Map_Set", stats::Measured<n_Map_Set> },
+	{ "Map_Get", stats::Measured<n_Map_Get> },
+	{ "Map_Contains", stats::Measured<n_Map_Contains> },
+	{ "Map_Remove", stats::Measured<n_Map_Remove> },
+	{ "Map_SetArray", stats::Measured<n_Map_SetArray> },
+	{ "Map_GetArray", stats::Measured<n_Map_GetArray> },
+	{ "Map_IterNext", stats::Measured<n_Map_IterNext> },
+	{ "Map_IterRemove", stats::Measured<n_Map_IterRemove> },
+	{ "Heap_Create", stats::Measured<n_Heap_Create> },
+	{ "Heap_Destroy", stats::Measured<n_Heap_Destroy> },
+	{ "Heap_Size", stats::Measured<n_Heap_Size> },
+	{ "Heap_Clear", stats::Measured<n_Heap_Clear> },
+	{ "Heap_Push", stats::Measured<n_Heap_Push> },
+	{ "Heap_Peek", stats::Measured<n_Heap_Peek> },
+	{ "Heap_Pop", stats::Measured<n_Heap_Pop> },
+	{ "Heap_DecreaseKey", stats::Measured<n_Heap_DecreaseKey> },
+	{ "Heap_Remove", stats::Measured<n_Heap_Remove> },
+	{ "Heap_Contains", stats::Measured<n_Heap_Contains> },
+	{ "Heap_GetPriority", stats::Measured<n_Heap_GetPriority> }
 };
 
 
@@ -636,6 +2731,7 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void **ppData)
 	logprintf = (void *(*)(const char *fmt, ...))ppData[PLUGIN_DATA_LOGPRINTF];
 	if (NULL == pAMXFunctions || NULL == logprintf)
 		return false;
+	stats::Register(plugin_natives, arraysize(plugin_natives));
 	int plug_ver_major, plug_ver_minor, plug_ver_build;
 	pluginutils::SplitVersion(PLUGIN_VERSION, plug_ver_major, plug_ver_minor, plug_ver_build);
 	logprintf("  ");
@@ -646,6 +2742,7 @@ PLUGIN_EXPORT bool PLUGIN_CALL Load(void **ppData)
 
 PLUGIN_EXPORT void PLUGIN_CALL Unload()
 {
+	tracing::Stop();
 	logprintf("  %s plugin was unloaded", PLUGIN_NAME);
 }
 
@@ -655,14 +2752,17 @@ PLUGIN_EXPORT int PLUGIN_CALL AmxLoad(AMX *amx)
 		return 0;
 
 	amx_Register(amx, plugin_natives, (int)arraysize(plugin_natives));
+	pluginutils::CacheNativeNames(amx);
 	return 1;
 }
 
 PLUGIN_EXPORT int PLUGIN_CALL AmxUnload(AMX *amx)
 {
-	vctID = 0;
-	vectors.clear();
-	copy_vectors.clear();
+	// Shared vectors have no owner, they outlive the scripts.
+	vectors.DestroyOwnedBy(amx);
+	maps.DestroyOwnedBy(amx);
+	heaps.DestroyOwnedBy(amx);
+	pluginutils::ForgetNativeNames(amx);
 	return AMX_ERR_NONE;
 }
 
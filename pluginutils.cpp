@@ -21,6 +21,8 @@ redistribute it freely, subject to the following restrictions:
 ==============================================================================*/
 
 #include <cstring>
+#include <unordered_map>
+#include <vector>
 #include "pluginutils.h"
 
 
@@ -67,6 +69,52 @@ namespace pluginutils
 		return false;
 	}
 
+	static const char str_unknown[] = "(unknown)";
+
+	struct NativeNames
+	{
+		std::vector<const char *> by_index;
+		std::unordered_map<ucell, const char *> by_address;
+	};
+
+	static std::unordered_map<AMX *, NativeNames> native_names;
+
+	static const char *GetNativeName(AMX_HEADER *hdr, AMX_FUNCSTUB *func)
+	{
+#if CUR_FILE_VERSION < 11
+		if (hdr->defsize == (int16_t)sizeof(AMX_FUNCSTUB))
+			return (const char *)func->name;
+		return (const char *)
+			((size_t)hdr + (size_t)((AMX_FUNCSTUBNT *)func)->nameofs);
+#else
+		return (const char *)((size_t)hdr + (size_t)func->nameofs);
+#endif
+	}
+
+	void CacheNativeNames(AMX *amx)
+	{
+		AMX_HEADER *hdr = (AMX_HEADER *)amx->base;
+		unsigned char *natives = (unsigned char *)hdr + (size_t)hdr->natives;
+		unsigned char *libraries = (unsigned char *)hdr + (size_t)hdr->libraries;
+		const size_t defsize = (size_t)hdr->defsize;
+		NativeNames &names = native_names[amx];
+		names.by_index.clear();
+		names.by_address.clear();
+		for (unsigned char *ptr = natives; ptr < libraries; ptr += defsize)
+		{
+			AMX_FUNCSTUB *func = (AMX_FUNCSTUB *)ptr;
+			const char *name = GetNativeName(hdr, func);
+			names.by_index.push_back(name);
+			if (func->address != 0)
+				names.by_address[func->address] = name;
+		}
+	}
+
+	void ForgetNativeNames(AMX *amx)
+	{
+		native_names.erase(amx);
+	}
+
 	const char *GetCurrentNativeFunctionName(AMX *amx)
 	{ // http://pro-pawn.ru/showthread.php?14522
 #if (6 <= CUR_FILE_VERSION) && (CUR_FILE_VERSION <= 8)
@@ -97,6 +145,7 @@ namespace pluginutils
 		unsigned char *code = amx->code;
 #endif
 		cell op_addr, opcode;
+		std::unordered_map<AMX *, NativeNames>::const_iterator cached = native_names.find(amx);
 
 		static cell *jump_table = NULL;
 		static bool jump_table_checked = false;
@@ -162,6 +211,9 @@ namespace pluginutils
 #endif
 			const cell func_index =
 				*(cell *)(void *)(code + (size_t)op_addr + sizeof(cell));
+			if (cached != native_names.end())
+				return (0 <= func_index && (size_t)func_index < cached->second.by_index.size())
+					? cached->second.by_index[(size_t)func_index] : str_unknown;
 			if (func_index < num_natives)
 				func = (AMX_FUNCSTUB *)((unsigned char *)(void *)natives +
 					(size_t)func_index * (size_t)hdr->defsize);
@@ -175,9 +227,16 @@ namespace pluginutils
 #endif
 			const ucell func_addr =
 				*(ucell *)(void *)(code + (size_t)op_addr + sizeof(cell));
+			if (cached != native_names.end())
+			{ // Natives registered or replaced after the cache was built aren't in it.
+				std::unordered_map<ucell, const char *>::const_iterator name =
+					cached->second.by_address.find(func_addr);
+				if (name != cached->second.by_address.end())
+					return name->second;
+			}
 			func = natives;
 			size_t libraries = (size_t)amx->base + (size_t)hdr->libraries;
-			for (; (size_t)natives < libraries; *((size_t *)&func) += defsize)
+			for (; (size_t)func < libraries; func = (AMX_FUNCSTUB *)((unsigned char *)func + defsize))
 				if (func->address == func_addr)
 					goto ret;
 			func = NULL;
@@ -185,17 +244,9 @@ namespace pluginutils
 		}
 
 	ret:
-		static const char str_unknown[] = "(unknown)";
 		if (NULL == func)
 			return str_unknown;
-#if CUR_FILE_VERSION < 11
-		if (hdr->defsize == (int16_t)sizeof(AMX_FUNCSTUB))
-			return (const char *)func->name;
-		return (const char *)
-			((size_t)hdr + (size_t)((AMX_FUNCSTUBNT *)func)->nameofs);
-#else
-		return (const char *)((size_t)hdr + (size_t)func->nameofs);
-#endif
+		return GetNativeName(hdr, func);
 	}
 
 	bool CheckNumberOfArguments(AMX *amx, const cell *params, int num_expected)
@@ -236,11 +287,12 @@ namespace pluginutils
 		return false;
 	}
 
-	char *GetCString(AMX *amx, cell address, int &error)
+	const char *GetCString(AMX *amx, cell address, int &error)
 	{
+		// Grows to the longest string read so far and is reused by every call.
+		static std::vector<char> buffer;
 		int len;
 		cell *cptr;
-		char *cstr;
 
 		error = amx_GetAddr(amx, address, &cptr);
 		if (error != AMX_ERR_NONE)
@@ -250,18 +302,14 @@ namespace pluginutils
 		if (error != AMX_ERR_NONE)
 			return NULL;
 
-		cstr = (char *)malloc((size_t)(len + 1) * sizeof(char));
-		if (cstr == NULL)
-		{
-			error = AMX_ERR_MEMORY;
-			return NULL;
-		}
+		if (buffer.size() < (size_t)(len + 1))
+			buffer.resize((size_t)(len + 1));
 
-		error = amx_GetString(cstr, cptr, 0, (size_t)(len + 1));
+		error = amx_GetString(buffer.data(), cptr, 0, (size_t)(len + 1));
 		if (error != AMX_ERR_NONE)
 			return NULL;
 
-		return cstr;
+		return buffer.data();
 	}
 
 	std::string GetCXXString(AMX *amx, cell address, int &error)
@@ -272,22 +320,22 @@ namespace pluginutils
 
 		error = amx_GetAddr(amx, address, &cptr);
 		if (error != AMX_ERR_NONE)
-			return NULL;
+			return std::string();
 
 		error = amx_StrLen(cptr, &len);
 		if (error != AMX_ERR_NONE)
-			return NULL;
+			return std::string();
 
 		cstr = (char *)alloca((size_t)(len + 1) * sizeof(char));
 		if (cstr == NULL)
 		{
 			error = AMX_ERR_MEMORY;
-			return NULL;
+			return std::string();
 		}
 
 		error = amx_GetString(cstr, cptr, 0, (size_t)(len + 1));
 		if (error != AMX_ERR_NONE)
-			return NULL;
+			return std::string();
 
 		std::string str(cstr);
 		return str;
@@ -302,7 +350,7 @@ namespace pluginutils
 		if (error != AMX_ERR_NONE)
 			return false;
 
-		return (amx_SetString(cptr, str, (pack) ? 1 : 0, 0, size) != AMX_ERR_NONE);
+		return (amx_SetString(cptr, str, (pack) ? 1 : 0, 0, size) == AMX_ERR_NONE);
 	}
 
 	bool SetCXXString(AMX *amx, cell address, cell size, const std::string &str, bool pack)
@@ -177,6 +177,15 @@ namespace pluginutils
 #endif // BYTE_ORDER == LITTLE_ENDIAN
 	}
 
+	/*
+		Builds the table of native names used by GetCurrentNativeFunctionName,
+		so the name is found in O(1) instead of walking the native table.
+		Call it once the natives are registered, and ForgetNativeNames when
+		the script is unloaded.
+	*/
+	void CacheNativeNames(AMX *amx);
+	void ForgetNativeNames(AMX *amx);
+
 	/*
 		Returns the name of the current native function.
 	*/
@@ -195,10 +204,10 @@ namespace pluginutils
 
 	/*
 		Obtains a NUL-terminated string, or returns NULL if the string address is invalid.
-		NOTE: The storage is allocated with 'malloc()' so in order to avoid memory leaks
-		the pointer must be passed to 'free()' when it's not needed anymore.
+		NOTE: The storage is a buffer shared by all the calls, the string is only valid
+		until the next call and must not be freed.
 	*/
-	char *GetCString(AMX *amx, cell address, int &error);
+	const char *GetCString(AMX *amx, cell address, int &error);
 
 	/*
 		Obtains a C++ string or returns an empty string if the address is invalid.
@@ -207,7 +216,7 @@ namespace pluginutils
 
 	/*
 		Sets a string in script memory from either a C string (NUL-terminated)
-		or a C++ string (std::string).
+		or a C++ string (std::string). Returns false if the address is invalid.
 	*/
 	bool SetCString(AMX *amx, cell address, cell size, const char *str, bool pack = false);
 	bool SetCXXString(AMX *amx, cell address, cell size, const std::string &str, bool pack = false);
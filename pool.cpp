@@ -0,0 +1,122 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <new>
+#include <vector>
+#include "pool.h"
+
+
+namespace pool
+{
+
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+
+	// One class per power of two from MIN_BLOCK_SIZE to MAX_POOLED_SIZE.
+	static const size_t NUM_CLASSES = 12;
+	static FreeBlock *free_lists[NUM_CLASSES];
+	// Every class carves its new blocks from the same slab.
+	static char *bump, *bump_end;
+	static std::vector<void *> slabs;
+	static Stats stats;
+
+	static size_t ClassOf(size_t bytes)
+	{
+		size_t index = 0;
+		for (size_t size = MIN_BLOCK_SIZE; size < bytes; size <<= 1)
+			++index;
+		return index;
+	}
+
+	static char *NewSlab()
+	{
+		char *slab = static_cast<char *>(::operator new(SLAB_SIZE));
+		slabs.push_back(slab);
+		stats.reserved += SLAB_SIZE;
+		return slab;
+	}
+
+	void *Allocate(size_t bytes)
+	{
+		if (bytes == 0)
+			bytes = 1;
+		stats.requested += bytes;
+		if (bytes > MAX_POOLED_SIZE)
+		{
+			stats.reserved += bytes;
+			stats.used += bytes;
+			return ::operator new(bytes);
+		}
+
+		const size_t index = ClassOf(bytes);
+		const size_t block_size = MIN_BLOCK_SIZE << index;
+		stats.used += block_size;
+		if (free_lists[index] != NULL)
+		{
+			FreeBlock *block = free_lists[index];
+			free_lists[index] = block->next;
+			stats.free -= block_size;
+			return block;
+		}
+		if (static_cast<size_t>(bump_end - bump) < block_size)
+		{ // The rest of the old slab is too small for this block and stays unused.
+			bump = NewSlab();
+			bump_end = bump + SLAB_SIZE;
+		}
+		void *block = bump;
+		bump += block_size;
+		return block;
+	}
+
+	void Deallocate(void *ptr, size_t bytes)
+	{
+		if (ptr == NULL)
+			return;
+		if (bytes == 0)
+			bytes = 1;
+		stats.requested -= bytes;
+		if (bytes > MAX_POOLED_SIZE)
+		{
+			stats.reserved -= bytes;
+			stats.used -= bytes;
+			::operator delete(ptr);
+			return;
+		}
+
+		const size_t index = ClassOf(bytes);
+		const size_t block_size = MIN_BLOCK_SIZE << index;
+		FreeBlock *block = static_cast<FreeBlock *>(ptr);
+		block->next = free_lists[index];
+		free_lists[index] = block;
+		stats.used -= block_size;
+		stats.free += block_size;
+	}
+
+	Stats GetStats()
+	{
+		return stats;
+	}
+
+}
@@ -0,0 +1,105 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef _POOL_H
+#define _POOL_H
+
+#include <cstddef>
+
+
+/*
+	Plugin-wide allocator of the vector storage.
+
+	Requests up to MAX_POOLED_SIZE bytes are rounded up to a power of two
+	size class and served from slabs of SLAB_SIZE bytes: new blocks are
+	carved from the current slab with a bump pointer, freed ones go to the
+	free list of their class for reuse. Slabs are never given back, which
+	keeps a long-running server from fragmenting the process heap with
+	many small buffers. Larger requests go straight to the heap.
+
+	Only the server thread may allocate.
+*/
+namespace pool
+{
+
+	const size_t MIN_BLOCK_SIZE = 16;
+	const size_t MAX_POOLED_SIZE = 32768;
+	const size_t SLAB_SIZE = 256 * 1024;
+
+	struct Stats
+	{
+		size_t reserved;  // bytes taken from the heap, slabs and large blocks
+		size_t used;      // bytes of the blocks handed out, rounded to their class
+		size_t requested; // bytes actually asked for
+		size_t free;      // bytes in the free lists, ready for reuse
+	};
+
+	void *Allocate(size_t bytes);
+	void Deallocate(void *ptr, size_t bytes);
+
+	/*
+		Returns the counters from which the fragmentation is measured:
+		used - requested is lost to rounding, reserved - used sits in free
+		lists or in the unused part of the slabs.
+	*/
+	Stats GetStats();
+
+	/*
+		Standard allocator on top of the pool, for the containers.
+	*/
+	template <typename T>
+	class Allocator
+	{
+	public:
+		typedef T value_type;
+
+		Allocator() {}
+		template <typename U>
+		Allocator(const Allocator<U> &) {}
+
+		T *allocate(size_t count)
+		{
+			return static_cast<T *>(Allocate(count * sizeof(T)));
+		}
+
+		void deallocate(T *ptr, size_t count)
+		{
+			Deallocate(ptr, count * sizeof(T));
+		}
+
+		template <typename U>
+		struct rebind
+		{
+			typedef Allocator<U> other;
+		};
+	};
+
+	template <typename T, typename U>
+	bool operator==(const Allocator<T> &, const Allocator<U> &) { return true; }
+	template <typename T, typename U>
+	bool operator!=(const Allocator<T> &, const Allocator<U> &) { return false; }
+
+}
+
+
+#endif // _POOL_H
@@ -0,0 +1,125 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include "recordtable.h"
+#include "simd.h"
+
+
+static const size_t MIN_CAPACITY = 8;
+
+RecordTable::RecordTable(size_t fields) :
+	fields(fields), count(0), capacity(0)
+{
+}
+
+void RecordTable::Reserve(size_t records)
+{
+	if (records <= capacity || fields == 0)
+		return;
+	// Every column moves to its new offset.
+	CellArray grown(fields * records);
+	for (size_t field = 0; field < fields; ++field)
+		std::copy(Column(field), Column(field) + count, grown.begin() + field * records);
+	cells.swap(grown);
+	capacity = records;
+}
+
+size_t RecordTable::Append(const int *record, size_t length)
+{
+	if (count == capacity)
+		Reserve(std::max(MIN_CAPACITY, 2 * capacity));
+	Assign(count, record, length);
+	return count++;
+}
+
+void RecordTable::Assign(size_t index, const int *record, size_t length)
+{
+	const size_t copied = std::min(length, fields);
+	for (size_t field = 0; field < copied; ++field)
+		SetField(index, field, record[field]);
+	for (size_t field = copied; field < fields; ++field)
+		SetField(index, field, 0);
+}
+
+size_t RecordTable::Copy(size_t index, int *dest, size_t maxlen) const
+{
+	const size_t copied = std::min(maxlen, fields);
+	for (size_t field = 0; field < copied; ++field)
+		dest[field] = Field(index, field);
+	return copied;
+}
+
+int RecordTable::Find(size_t field, int value, size_t start) const
+{
+	if (start >= count)
+		return -1;
+	const int index = simd::Find(Column(field) + start, count - start, value);
+	return index == -1 ? -1 : static_cast<int>(start) + index;
+}
+
+void RecordTable::EraseAt(size_t index)
+{
+	const size_t last = count - 1;
+	if (index != last)
+		for (size_t field = 0; field < fields; ++field)
+			SetField(index, field, Field(last, field));
+	--count;
+}
+
+void RecordTable::Sort(size_t field, bool descending, bool floats)
+{ // Sorts the positions on the one column, then gathers every column in that order.
+	const int *keys = Column(field);
+	CellArray float_keys;
+	if (floats)
+	{ // FloatKey() maps the Float bits to ints that order like the Floats.
+		float_keys.resize(count);
+		for (size_t i = 0; i < count; ++i)
+			float_keys[i] = simd::FloatKey(keys[i]);
+		keys = float_keys.data();
+	}
+	std::vector<uint32_t, pool::Allocator<uint32_t> > order(count);
+	for (size_t i = 0; i < count; ++i)
+		order[i] = static_cast<uint32_t>(i);
+	if (descending)
+		std::stable_sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+	else
+		std::stable_sort(order.begin(), order.end(), [keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+
+	CellArray column(count);
+	for (size_t f = 0; f < fields; ++f)
+	{
+		int *first = cells.data() + f * capacity;
+		for (size_t i = 0; i < count; ++i)
+			column[i] = first[order[i]];
+		std::copy(column.begin(), column.end(), first);
+	}
+}
+
+void RecordTable::Swap(RecordTable &other)
+{
+	std::swap(fields, other.fields);
+	std::swap(count, other.count);
+	std::swap(capacity, other.capacity);
+	cells.swap(other.cells);
+}
@@ -0,0 +1,126 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _RECORDTABLE_H
+#define _RECORDTABLE_H
+
+#include <cstddef>
+#include <vector>
+#include "pool.h"
+
+
+/*
+	Storage engine of a record vector: records of a fixed number of fields
+	(cells), stored field by field. Each field is a contiguous column of
+	Capacity() cells in a single pooled block, so scanning or sorting on one
+	field only touches that column, while copying a whole record gathers
+	one cell from every column.
+
+	Removing a record moves the last one into its place, like removing from
+	a vector. A table with no fields is the empty default state.
+*/
+class RecordTable
+{
+public:
+	explicit RecordTable(size_t fields = 0);
+
+	size_t Fields() const { return fields; }
+	size_t Size() const { return count; }
+	bool Empty() const { return count == 0; }
+	size_t Capacity() const { return capacity; }
+
+	int Field(size_t index, size_t field) const { return cells[field * capacity + index]; }
+	void SetField(size_t index, size_t field, int value) { cells[field * capacity + index] = value; }
+
+	/*
+		Returns the column of a field, Size() cells.
+	*/
+	const int *Column(size_t field) const { return cells.data() + field * capacity; }
+
+	/*
+		Appends a record made of the given cells, missing fields are 0 and
+		extra cells are ignored. Returns the index of the record.
+	*/
+	size_t Append(const int *record, size_t length);
+
+	/*
+		Overwrites the record at the given index like Append() fills a new
+		one. The index must be valid.
+	*/
+	void Assign(size_t index, const int *record, size_t length);
+
+	/*
+		Copies up to maxlen fields of the record at the given index. Returns
+		the number of cells copied.
+	*/
+	size_t Copy(size_t index, int *dest, size_t maxlen) const;
+
+	/*
+		Returns the index of the first record from 'start' on whose field
+		holds the value, or -1.
+	*/
+	int Find(size_t field, int value, size_t start) const;
+
+	/*
+		Removes the record at the given index by moving the last one into
+		its place. The index must be valid.
+	*/
+	void EraseAt(size_t index);
+
+	/*
+		Sorts the records on one field, records with equal fields keep their
+		relative order. The field is compared as Floats when floats is set,
+		otherwise as ints.
+	*/
+	void Sort(size_t field, bool descending, bool floats);
+
+	/*
+		Makes room for the given number of records.
+	*/
+	void Reserve(size_t records);
+
+	/*
+		Removes all records, keeping the allocated capacity.
+	*/
+	void Clear() { count = 0; }
+
+	/*
+		Exchanges the contents with another table.
+	*/
+	void Swap(RecordTable &other);
+
+	/*
+		Returns the number of bytes allocated on the heap for the records.
+	*/
+	size_t MemoryUsage() const { return cells.capacity() * sizeof(int); }
+
+private:
+	typedef std::vector<int, pool::Allocator<int> > CellArray;
+
+	size_t fields;
+	size_t count;
+	size_t capacity;
+	CellArray cells;
+};
+
+
+#endif // _RECORDTABLE_H
@@ -0,0 +1,410 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#include <cstring>
+#include "simd.h"
+
+#if defined __i386__ || defined __x86_64__ || defined _M_IX86 || defined _M_X64
+	#define SIMD_X86
+	#include <immintrin.h>
+	#if defined _MSC_VER
+		#include <intrin.h>
+		// MSVC accepts any intrinsic without a target option.
+		#define TARGET_SSE41
+		#define TARGET_AVX2
+	#else
+		#define TARGET_SSE41 __attribute__((target("sse4.1")))
+		#define TARGET_AVX2 __attribute__((target("avx2")))
+	#endif
+#endif
+
+
+namespace simd
+{
+
+	struct Kernels
+	{
+		int (*find)(const int *data, size_t count, int value);
+		size_t (*count_in_range)(const int *data, size_t count, int lo, int hi);
+		void (*min_max)(const int *data, size_t count, int &min, int &max);
+		int64_t (*sum)(const int *data, size_t count);
+		double (*sum_float_keys)(const int *data, size_t count);
+	};
+
+	static int FindScalar(const int *data, size_t count, int value)
+	{
+		for (size_t i = 0; i < count; ++i)
+			if (data[i] == value)
+				return static_cast<int>(i);
+		return -1;
+	}
+
+	static size_t CountInRangeScalar(const int *data, size_t count, int lo, int hi)
+	{
+		size_t result = 0;
+		for (size_t i = 0; i < count; ++i)
+			result += (data[i] >= lo && data[i] <= hi);
+		return result;
+	}
+
+	static void MinMaxScalar(const int *data, size_t count, int &min, int &max)
+	{
+		min = max = data[0];
+		for (size_t i = 1; i < count; ++i)
+		{
+			if (data[i] < min)
+				min = data[i];
+			if (data[i] > max)
+				max = data[i];
+		}
+	}
+
+	static int64_t SumScalar(const int *data, size_t count)
+	{
+		int64_t result = 0;
+		for (size_t i = 0; i < count; ++i)
+			result += data[i];
+		return result;
+	}
+
+	static double SumFloatKeysScalar(const int *data, size_t count)
+	{
+		double result = 0.0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const int bits = FloatKey(data[i]);
+			float value;
+			memcpy(&value, &bits, sizeof(value));
+			result += value;
+		}
+		return result;
+	}
+
+#if defined SIMD_X86
+	static unsigned int LowestBit(unsigned int mask)
+	{
+#if defined _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, mask);
+		return index;
+#else
+		return static_cast<unsigned int>(__builtin_ctz(mask));
+#endif
+	}
+
+	TARGET_SSE41 static int FindSSE41(const int *data, size_t count, int value)
+	{
+		const __m128i needle = _mm_set1_epi32(value);
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i equal = _mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)), needle);
+			const int mask = _mm_movemask_ps(_mm_castsi128_ps(equal));
+			if (mask != 0)
+				return static_cast<int>(i + LowestBit(static_cast<unsigned int>(mask)));
+		}
+		const int rest = FindScalar(data + i, count - i, value);
+		return rest == -1 ? -1 : static_cast<int>(i) + rest;
+	}
+
+	TARGET_SSE41 static size_t CountInRangeSSE41(const int *data, size_t count, int lo, int hi)
+	{
+		const __m128i low = _mm_set1_epi32(lo), high = _mm_set1_epi32(hi);
+		__m128i counts = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			// Out of range lanes are all ones, in range lanes are subtracted as -1.
+			const __m128i outside = _mm_or_si128(_mm_cmpgt_epi32(low, values), _mm_cmpgt_epi32(values, high));
+			counts = _mm_sub_epi32(counts, _mm_andnot_si128(outside, _mm_set1_epi32(-1)));
+		}
+		unsigned int lanes[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), counts);
+		return static_cast<size_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3] + CountInRangeScalar(data + i, count - i, lo, hi);
+	}
+
+	TARGET_SSE41 static void MinMaxSSE41(const int *data, size_t count, int &min, int &max)
+	{
+		if (count < 4)
+			return MinMaxScalar(data, count, min, max);
+		__m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data)), high = low;
+		size_t i = 4;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			low = _mm_min_epi32(low, values);
+			high = _mm_max_epi32(high, values);
+		}
+		int lows[4], highs[4];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lows), low);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(highs), high);
+		min = lows[0];
+		max = highs[0];
+		for (int lane = 1; lane < 4; ++lane)
+		{
+			if (lows[lane] < min)
+				min = lows[lane];
+			if (highs[lane] > max)
+				max = highs[lane];
+		}
+		for (; i < count; ++i)
+		{
+			if (data[i] < min)
+				min = data[i];
+			if (data[i] > max)
+				max = data[i];
+		}
+	}
+
+	TARGET_SSE41 static int64_t SumSSE41(const int *data, size_t count)
+	{ // Widened to 64-bit lanes before adding.
+		__m128i sums = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			sums = _mm_add_epi64(sums, _mm_cvtepi32_epi64(values));
+			sums = _mm_add_epi64(sums, _mm_cvtepi32_epi64(_mm_srli_si128(values, 8)));
+		}
+		int64_t lanes[2];
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sums);
+		return lanes[0] + lanes[1] + SumScalar(data + i, count - i);
+	}
+
+	TARGET_SSE41 static double SumFloatKeysSSE41(const int *data, size_t count)
+	{ // FloatKey() flips the magnitude bits of the negative keys back.
+		const __m128i magnitude = _mm_set1_epi32(0x7FFFFFFF);
+		__m128d sums = _mm_setzero_pd();
+		size_t i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			const __m128i keys = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			const __m128 values = _mm_castsi128_ps(_mm_xor_si128(keys, _mm_and_si128(_mm_srai_epi32(keys, 31), magnitude)));
+			sums = _mm_add_pd(sums, _mm_cvtps_pd(values));
+			sums = _mm_add_pd(sums, _mm_cvtps_pd(_mm_movehl_ps(values, values)));
+		}
+		double lanes[2];
+		_mm_storeu_pd(lanes, sums);
+		return lanes[0] + lanes[1] + SumFloatKeysScalar(data + i, count - i);
+	}
+
+	TARGET_AVX2 static int FindAVX2(const int *data, size_t count, int value)
+	{
+		const __m256i needle = _mm256_set1_epi32(value);
+		size_t i = 0;
+		// Four vectors per iteration, located precisely only once one of them matches.
+		for (; i + 32 <= count; i += 32)
+		{
+			const __m256i a = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), needle);
+			const __m256i b = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 8)), needle);
+			const __m256i c = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 16)), needle);
+			const __m256i d = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + 24)), needle);
+			if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(a, b), _mm256_or_si256(c, d)), _mm256_set1_epi32(-1)))
+				break;
+		}
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i equal = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)), needle);
+			const int mask = _mm256_movemask_ps(_mm256_castsi256_ps(equal));
+			if (mask != 0)
+				return static_cast<int>(i + LowestBit(static_cast<unsigned int>(mask)));
+		}
+		const int rest = FindScalar(data + i, count - i, value);
+		return rest == -1 ? -1 : static_cast<int>(i) + rest;
+	}
+
+	TARGET_AVX2 static size_t CountInRangeAVX2(const int *data, size_t count, int lo, int hi)
+	{
+		const __m256i low = _mm256_set1_epi32(lo), high = _mm256_set1_epi32(hi), ones = _mm256_set1_epi32(-1);
+		__m256i counts = _mm256_setzero_si256();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+			const __m256i outside = _mm256_or_si256(_mm256_cmpgt_epi32(low, values), _mm256_cmpgt_epi32(values, high));
+			counts = _mm256_sub_epi32(counts, _mm256_andnot_si256(outside, ones));
+		}
+		unsigned int lanes[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), counts);
+		size_t result = CountInRangeScalar(data + i, count - i, lo, hi);
+		for (int lane = 0; lane < 8; ++lane)
+			result += lanes[lane];
+		return result;
+	}
+
+	TARGET_AVX2 static void MinMaxAVX2(const int *data, size_t count, int &min, int &max)
+	{
+		if (count < 8)
+			return MinMaxSSE41(data, count, min, max);
+		__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), high = low;
+		size_t i = 8;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+			low = _mm256_min_epi32(low, values);
+			high = _mm256_max_epi32(high, values);
+		}
+		int lows[8], highs[8];
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(lows), low);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(highs), high);
+		min = lows[0];
+		max = highs[0];
+		for (int lane = 1; lane < 8; ++lane)
+		{
+			if (lows[lane] < min)
+				min = lows[lane];
+			if (highs[lane] > max)
+				max = highs[lane];
+		}
+		for (; i < count; ++i)
+		{
+			if (data[i] < min)
+				min = data[i];
+			if (data[i] > max)
+				max = data[i];
+		}
+	}
+
+	TARGET_AVX2 static int64_t SumAVX2(const int *data, size_t count)
+	{
+		__m256i sums = _mm256_setzero_si256();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+			const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + 4));
+			sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(low));
+			sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(high));
+		}
+		int64_t lanes[4];
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(lanes), sums);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumScalar(data + i, count - i);
+	}
+
+	TARGET_AVX2 static double SumFloatKeysAVX2(const int *data, size_t count)
+	{
+		const __m256i magnitude = _mm256_set1_epi32(0x7FFFFFFF);
+		__m256d sums = _mm256_setzero_pd();
+		size_t i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			const __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+			const __m256 values = _mm256_castsi256_ps(_mm256_xor_si256(keys, _mm256_and_si256(_mm256_srai_epi32(keys, 31), magnitude)));
+			sums = _mm256_add_pd(sums, _mm256_cvtps_pd(_mm256_castps256_ps128(values)));
+			sums = _mm256_add_pd(sums, _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1)));
+		}
+		double lanes[4];
+		_mm256_storeu_pd(lanes, sums);
+		return lanes[0] + lanes[1] + lanes[2] + lanes[3] + SumFloatKeysScalar(data + i, count - i);
+	}
+
+	static Level DetectLevel()
+	{
+#if defined _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		const int max_leaf = info[0];
+		__cpuid(info, 1);
+		const bool sse41 = (info[2] & (1 << 19)) != 0;
+		// AVX2 also needs the OS to save the YMM registers (OSXSAVE and XCR0).
+		const bool os_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+		bool avx2 = false;
+		if (max_leaf >= 7 && os_avx)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = (info[1] & (1 << 5)) != 0;
+		}
+#else
+		__builtin_cpu_init();
+		const bool sse41 = __builtin_cpu_supports("sse4.1") != 0;
+		const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+#endif
+		if (avx2)
+			return LEVEL_AVX2;
+		if (sse41)
+			return LEVEL_SSE41;
+		return LEVEL_SCALAR;
+	}
+#else
+	static Level DetectLevel()
+	{
+		return LEVEL_SCALAR;
+	}
+#endif // SIMD_X86
+
+	static const Kernels kernels[] =
+	{
+		{ FindScalar, CountInRangeScalar, MinMaxScalar, SumScalar, SumFloatKeysScalar },
+#if defined SIMD_X86
+		{ FindSSE41, CountInRangeSSE41, MinMaxSSE41, SumSSE41, SumFloatKeysSSE41 },
+		{ FindAVX2, CountInRangeAVX2, MinMaxAVX2, SumAVX2, SumFloatKeysAVX2 },
+#endif
+	};
+
+	static Level detected_level = DetectLevel();
+	static Level level = detected_level;
+
+	Level GetLevel()
+	{
+		return level;
+	}
+
+	void SetLevel(Level new_level)
+	{
+		if (new_level <= detected_level)
+			level = new_level;
+	}
+
+	const char *GetLevelName(Level name_level)
+	{
+		static const char *const names[] = { "scalar", "SSE4.1", "AVX2" };
+		return names[name_level];
+	}
+
+	int Find(const int *data, size_t count, int value)
+	{
+		return kernels[level].find(data, count, value);
+	}
+
+	size_t CountInRange(const int *data, size_t count, int lo, int hi)
+	{
+		return kernels[level].count_in_range(data, count, lo, hi);
+	}
+
+	void MinMax(const int *data, size_t count, int &min, int &max)
+	{
+		kernels[level].min_max(data, count, min, max);
+	}
+
+	int64_t Sum(const int *data, size_t count)
+	{
+		return kernels[level].sum(data, count);
+	}
+
+	double SumFloatKeys(const int *data, size_t count)
+	{
+		return kernels[level].sum_float_keys(data, count);
+	}
+
+}
@@ -0,0 +1,99 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef _SIMD_H
+#define _SIMD_H
+
+#include <cstddef>
+#include <cstdint>
+
+
+/*
+	Scan kernels over arrays of ints, in AVX2, SSE4.1 and plain C++
+	versions. The CPU is probed once when the plugin is loaded (a static
+	initializer) and the best version it supports is used from then on;
+	non-x86 builds only have the scalar one.
+*/
+namespace simd
+{
+
+	enum Level
+	{
+		LEVEL_SCALAR,
+		LEVEL_SSE41,
+		LEVEL_AVX2
+	};
+
+	/*
+		Returns the instruction set level in use.
+	*/
+	Level GetLevel();
+
+	/*
+		Forces a lower level than the detected one, used to compare the
+		kernels. A level the CPU doesn't support is ignored.
+	*/
+	void SetLevel(Level level);
+
+	const char *GetLevelName(Level level);
+
+	/*
+		Returns the position of the first element equal to the value, or -1.
+	*/
+	int Find(const int *data, size_t count, int value);
+
+	/*
+		Counts the elements in the range [lo, hi].
+	*/
+	size_t CountInRange(const int *data, size_t count, int lo, int hi);
+
+	/*
+		Finds the smallest and the largest element, count must not be 0.
+	*/
+	void MinMax(const int *data, size_t count, int &min, int &max);
+
+	/*
+		Adds up the elements without overflowing.
+	*/
+	int64_t Sum(const int *data, size_t count);
+
+	/*
+		Maps the bits of a Float to an int which compares like the Float
+		(-0.0 right below 0.0, NaNs beyond the infinities), so the kernels
+		above work on Floats too. The mapping is its own inverse.
+	*/
+	inline int FloatKey(int bits)
+	{
+		const uint32_t value = static_cast<uint32_t>(bits);
+		return static_cast<int>(value ^ ((value >> 31) * 0x7FFFFFFFu));
+	}
+
+	/*
+		Adds up elements stored as FloatKey()s in double precision.
+	*/
+	double SumFloatKeys(const int *data, size_t count);
+
+}
+
+
+#endif // _SIMD_H
@@ -0,0 +1,230 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+
+#ifndef _SMALLARRAY_H
+#define _SMALLARRAY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+#include "pool.h"
+
+
+/*
+	Dynamic array holding up to N elements inside the object itself and
+	moving them to a buffer from the pool only when it grows past that,
+	so a tiny container costs no allocation at all. The interface is the
+	subset of std::vector the containers of the plugin use.
+
+	T must be trivially copyable, elements are moved with memcpy.
+*/
+template <typename T, size_t N>
+class SmallArray
+{
+public:
+	typedef T value_type;
+	typedef T *iterator;
+	typedef const T *const_iterator;
+
+	SmallArray() : first(inline_buffer), count(0), allocated(N) {}
+
+	SmallArray(const T *begin, const T *end) : first(inline_buffer), count(0), allocated(N)
+	{
+		insert(this->end(), begin, end);
+	}
+
+	SmallArray(const SmallArray &other) : first(inline_buffer), count(0), allocated(N)
+	{
+		insert(end(), other.begin(), other.end());
+	}
+
+	SmallArray(SmallArray &&other) noexcept : first(inline_buffer), count(0), allocated(N)
+	{
+		swap(other);
+	}
+
+	~SmallArray()
+	{
+		if (!IsInline())
+			pool::Deallocate(first, allocated * sizeof(T));
+	}
+
+	SmallArray &operator=(SmallArray other)
+	{
+		swap(other);
+		return *this;
+	}
+
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	size_t capacity() const { return allocated; }
+	bool IsInline() const { return first == inline_buffer; }
+
+	T *data() { return first; }
+	const T *data() const { return first; }
+	T &operator[](size_t index) { return first[index]; }
+	const T &operator[](size_t index) const { return first[index]; }
+	T &front() { return first[0]; }
+	const T &front() const { return first[0]; }
+	T &back() { return first[count - 1]; }
+	const T &back() const { return first[count - 1]; }
+
+	iterator begin() { return first; }
+	iterator end() { return first + count; }
+	const_iterator begin() const { return first; }
+	const_iterator end() const { return first + count; }
+
+	void push_back(const T &value)
+	{
+		if (count == allocated)
+			Grow(count + 1);
+		first[count++] = value;
+	}
+
+	void pop_back()
+	{
+		--count;
+	}
+
+	iterator insert(iterator position, const T &value)
+	{
+		const size_t index = static_cast<size_t>(position - first);
+		if (count == allocated)
+			Grow(count + 1);
+		memmove(first + index + 1, first + index, (count - index) * sizeof(T));
+		first[index] = value;
+		++count;
+		return first + index;
+	}
+
+	iterator insert(iterator position, const T *begin, const T *end)
+	{
+		const size_t index = static_cast<size_t>(position - first), added = static_cast<size_t>(end - begin);
+		if (count + added > allocated)
+			Grow(count + added);
+		memmove(first + index + added, first + index, (count - index) * sizeof(T));
+		memcpy(first + index, begin, added * sizeof(T));
+		count += static_cast<uint32_t>(added);
+		return first + index;
+	}
+
+	iterator erase(iterator position)
+	{
+		return erase(position, position + 1);
+	}
+
+	iterator erase(iterator begin, iterator end)
+	{
+		memmove(begin, end, static_cast<size_t>(this->end() - end) * sizeof(T));
+		count -= static_cast<uint32_t>(end - begin);
+		return begin;
+	}
+
+	void clear()
+	{
+		count = 0;
+	}
+
+	void reserve(size_t capacity)
+	{
+		if (capacity > allocated)
+			Reallocate(capacity);
+	}
+
+	/*
+		Moves the elements back inside the object if they fit, otherwise
+		to a buffer of exactly their size.
+	*/
+	void shrink_to_fit()
+	{
+		if (!IsInline() && count < allocated)
+			Reallocate(count);
+	}
+
+	void swap(SmallArray &other)
+	{
+		if (!IsInline() && !other.IsInline())
+		{
+			std::swap(first, other.first);
+			std::swap(count, other.count);
+			std::swap(allocated, other.allocated);
+			return;
+		}
+		// At least one side is inline: go through a temporary, steal any heap buffer.
+		SmallArray temp;
+		temp.Take(other);
+		other.Take(*this);
+		Take(temp);
+	}
+
+private:
+	void Grow(size_t needed)
+	{
+		size_t capacity = allocated * 2;
+		if (capacity < needed)
+			capacity = needed;
+		Reallocate(capacity);
+	}
+
+	// Capacity must not be smaller than the number of elements.
+	void Reallocate(size_t capacity)
+	{
+		T *buffer = (capacity <= N) ? inline_buffer : static_cast<T *>(pool::Allocate(capacity * sizeof(T)));
+		if (buffer == first)
+			return;
+		memcpy(buffer, first, count * sizeof(T));
+		if (!IsInline())
+			pool::Deallocate(first, allocated * sizeof(T));
+		first = buffer;
+		allocated = static_cast<uint32_t>(capacity <= N ? N : capacity);
+	}
+
+	// Moves the contents of other, which is left empty and inline, into this empty array.
+	void Take(SmallArray &other)
+	{
+		if (other.IsInline())
+		{
+			memcpy(inline_buffer, other.inline_buffer, other.count * sizeof(T));
+			first = inline_buffer;
+			allocated = N;
+		}
+		else
+		{
+			first = other.first;
+			allocated = other.allocated;
+		}
+		count = other.count;
+		other.first = other.inline_buffer;
+		other.count = 0;
+		other.allocated = N;
+	}
+
+	T *first;
+	uint32_t count;
+	uint32_t allocated;
+	T inline_buffer[N];
+};
+
+
+#endif // _SMALLARRAY_H
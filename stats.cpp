@@ -0,0 +1,163 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "stats.h"
+
+
+namespace stats
+{
+
+	static std::vector<NativeStats> natives_stats;
+	static NativeStats unregistered;
+
+	static uint64_t origin_ticks;
+	static std::chrono::steady_clock::time_point origin_time;
+
+	double NanosecondsPerTick()
+	{
+#if defined STATS_USE_TSC
+		const uint64_t ticks = Ticks() - origin_ticks;
+		const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - origin_time).count();
+		return ticks == 0 ? 0.0 : ns / static_cast<double>(ticks);
+#else
+		return 1.0;
+#endif
+	}
+
+	static void Clear(NativeStats &entry)
+	{
+		entry.calls = 0;
+		entry.total_ticks = 0;
+		entry.max_ticks = 0;
+		memset(entry.histogram, 0, sizeof(entry.histogram));
+	}
+
+	void Register(const AMX_NATIVE_INFO *natives, size_t count)
+	{
+		natives_stats.resize(count);
+		for (size_t i = 0; i < count; ++i)
+		{
+			natives_stats[i].name = natives[i].name;
+			natives_stats[i].function = natives[i].func;
+			Clear(natives_stats[i]);
+		}
+		unregistered.name = "(unregistered)";
+		unregistered.function = NULL;
+		Clear(unregistered);
+		origin_ticks = Ticks();
+		origin_time = std::chrono::steady_clock::now();
+	}
+
+	NativeStats &Lookup(AMX_NATIVE function)
+	{
+		for (size_t i = 0; i < natives_stats.size(); ++i)
+			if (natives_stats[i].function == function)
+				return natives_stats[i];
+		return unregistered;
+	}
+
+	const NativeStats *Find(const char *name)
+	{
+		for (size_t i = 0; i < natives_stats.size(); ++i)
+			if (strcmp(natives_stats[i].name, name) == 0)
+				return &natives_stats[i];
+		return NULL;
+	}
+
+	static uint64_t BucketUpperBound(unsigned int bucket)
+	{
+		if (bucket < SUB_BUCKETS)
+			return bucket;
+		const unsigned int shift = bucket / SUB_BUCKETS - 1;
+		const uint64_t low = static_cast<uint64_t>(SUB_BUCKETS + bucket % SUB_BUCKETS) << shift;
+		return low + (static_cast<uint64_t>(1) << shift) - 1;
+	}
+
+	uint64_t Percentile(const NativeStats &entry, double fraction)
+	{
+		if (entry.calls == 0)
+			return 0;
+		uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(entry.calls) + 0.5);
+		if (rank == 0)
+			rank = 1;
+		uint64_t seen = 0;
+		for (unsigned int bucket = 0; bucket < HISTOGRAM_BUCKETS; ++bucket)
+		{
+			seen += entry.histogram[bucket];
+			if (seen >= rank)
+				return std::min(BucketUpperBound(bucket), entry.max_ticks);
+		}
+		return entry.max_ticks;
+	}
+
+	void Reset()
+	{
+		for (size_t i = 0; i < natives_stats.size(); ++i)
+			Clear(natives_stats[i]);
+		Clear(unregistered);
+	}
+
+	static bool ByTotalTime(const NativeStats *a, const NativeStats *b)
+	{
+		return a->total_ticks > b->total_ticks;
+	}
+
+	bool Dump(const char *file_name)
+	{
+		FILE *file = fopen(file_name, "w");
+		if (file == NULL)
+			return false;
+
+		// The natives taking the most time overall come first.
+		std::vector<const NativeStats *> called;
+		for (size_t i = 0; i < natives_stats.size(); ++i)
+			if (natives_stats[i].calls != 0)
+				called.push_back(&natives_stats[i]);
+		std::sort(called.begin(), called.end(), ByTotalTime);
+		const double us_per_tick = NanosecondsPerTick() / 1e3;
+
+		fprintf(file, "%-24s %12s %12s %10s %10s %10s %10s %10s\n",
+			"native", "calls", "total ms", "avg us", "p50 us", "p99 us", "p99.9 us", "max us");
+		for (size_t i = 0; i < called.size(); ++i)
+		{
+			const NativeStats &entry = *called[i];
+			fprintf(file, "%-24s %12llu %12.3f %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+				entry.name,
+				static_cast<unsigned long long>(entry.calls),
+				entry.total_ticks * us_per_tick / 1e3,
+				entry.total_ticks * us_per_tick / entry.calls,
+				Percentile(entry, 0.5) * us_per_tick,
+				Percentile(entry, 0.99) * us_per_tick,
+				Percentile(entry, 0.999) * us_per_tick,
+				entry.max_ticks * us_per_tick);
+		}
+		fclose(file);
+		return true;
+	}
+
+}
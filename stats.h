@@ -0,0 +1,170 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#ifndef _STATS_H
+#define _STATS_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "SDK/amx/amx.h"
+
+#if defined _MSC_VER && (defined _M_IX86 || defined _M_X64)
+	#include <intrin.h>
+	#define STATS_USE_TSC
+#elif (defined __GNUC__ || defined __clang__) && (defined __i386__ || defined __x86_64__)
+	#include <x86intrin.h>
+	#define STATS_USE_TSC
+#endif
+
+
+/*
+	Always-on instrumentation of the natives: call count, total and maximum
+	time and a latency histogram for every native registered by the plugin.
+
+	The histogram is HDR-style: values below SUB_BUCKETS ticks get a
+	bucket each, above that every power of two is split into SUB_BUCKETS
+	linear buckets, so any recorded latency is known within 1/SUB_BUCKETS
+	of its value whatever its magnitude.
+
+	Times are taken from the time stamp counter on x86, which is much cheaper
+	to read than the system clock, and converted to nanoseconds only when
+	read back. The histogram works on the raw ticks, its precision doesn't
+	depend on the unit.
+
+	A native is instrumented by registering stats::Measured<native> in its
+	place, the natives table must be passed to Register() before the first
+	call.
+*/
+namespace stats
+{
+
+	const unsigned int SUB_BUCKET_BITS = 3;
+	const unsigned int SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+	const unsigned int HISTOGRAM_BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+	struct NativeStats
+	{
+		const char *name;
+		AMX_NATIVE function;
+		uint64_t calls;
+		uint64_t total_ticks;
+		uint64_t max_ticks;
+		uint32_t histogram[HISTOGRAM_BUCKETS];
+	};
+
+	inline uint64_t Ticks()
+	{
+#if defined STATS_USE_TSC
+		return __rdtsc();
+#else
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+	}
+
+	/*
+		Returns the length of a tick in nanoseconds. The time stamp counter is
+		calibrated against the system clock over the time since Register().
+	*/
+	double NanosecondsPerTick();
+
+	/*
+		Creates the statistics of every native in the table.
+	*/
+	void Register(const AMX_NATIVE_INFO *natives, size_t count);
+
+	/*
+		Returns the statistics of the native registered with the given
+		function, or of a catch-all entry if it wasn't registered.
+	*/
+	NativeStats &Lookup(AMX_NATIVE function);
+
+	/*
+		Returns the statistics of the native with the given name, or NULL.
+	*/
+	const NativeStats *Find(const char *name);
+
+	/*
+		Returns the latency (in ticks) below which the given fraction of the
+		calls completed, e.g. 0.99 for the 99th percentile.
+	*/
+	uint64_t Percentile(const NativeStats &entry, double fraction);
+
+	/*
+		Clears the statistics of every native.
+	*/
+	void Reset();
+
+	/*
+		Writes a table of the natives which were called to the file.
+		Returns false if the file couldn't be opened.
+	*/
+	bool Dump(const char *file_name);
+
+	inline unsigned int BucketOf(uint64_t ticks)
+	{
+		if (ticks < SUB_BUCKETS)
+			return static_cast<unsigned int>(ticks);
+		unsigned int high_bit;
+#if defined __GNUC__
+		high_bit = 63 - static_cast<unsigned int>(__builtin_clzll(ticks));
+#else
+		high_bit = 0;
+		for (uint64_t rest = ticks; rest > 1; rest >>= 1)
+			++high_bit;
+#endif
+		const unsigned int shift = high_bit - SUB_BUCKET_BITS;
+		return (shift + 1) * SUB_BUCKETS + static_cast<unsigned int>((ticks >> shift) & (SUB_BUCKETS - 1));
+	}
+
+	class Timer
+	{
+	public:
+		explicit Timer(NativeStats &entry) : entry(entry), start(Ticks()) {}
+		~Timer()
+		{
+			const uint64_t ticks = Ticks() - start;
+			++entry.calls;
+			entry.total_ticks += ticks;
+			if (ticks > entry.max_ticks)
+				entry.max_ticks = ticks;
+			++entry.histogram[BucketOf(ticks)];
+		}
+
+	private:
+		NativeStats &entry;
+		uint64_t start;
+	};
+
+	template <AMX_NATIVE native>
+	cell AMX_NATIVE_CALL Measured(AMX *amx, cell *params)
+	{
+		static NativeStats &entry = Lookup(&Measured<native>);
+		Timer timer(entry);
+		return native(amx, params);
+	}
+
+}
+
+
+#endif // _STATS_H
@@ -0,0 +1,189 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#include <cstring>
+#include <cstdint>
+#include "pool.h"
+#include "stringpool.h"
+
+
+namespace stringpool
+{
+
+	struct Entry
+	{
+		char *text; // NULL while the ID is free
+		uint32_t length;
+		uint32_t hash;
+	};
+
+	static const int32_t EMPTY_SLOT = -1;
+	static const size_t MIN_INDEX_CAPACITY = 64;
+
+	static std::vector<Entry> entries;
+	static std::vector<int> free_ids;
+	// IDs of the strings by hash, linear probing. At most 3/4 full.
+	static std::vector<int32_t> slots;
+	static size_t count;
+
+	static uint32_t Hash(const char *text, size_t length)
+	{ // FNV-1a
+		uint32_t hash = 2166136261u;
+		for (size_t i = 0; i < length; ++i)
+			hash = (hash ^ static_cast<unsigned char>(text[i])) * 16777619u;
+		return hash;
+	}
+
+	static size_t Home(uint32_t hash)
+	{
+		return static_cast<size_t>(hash) & (slots.size() - 1);
+	}
+
+	static void InsertSlot(int id)
+	{
+		const size_t mask = slots.size() - 1;
+		size_t i = Home(entries[id].hash);
+		while (slots[i] != EMPTY_SLOT)
+			i = (i + 1) & mask;
+		slots[i] = id;
+	}
+
+	static void Rehash(size_t capacity)
+	{
+		slots.assign(capacity, EMPTY_SLOT);
+		for (size_t id = 0; id < entries.size(); ++id)
+			if (entries[id].text != NULL)
+				InsertSlot(static_cast<int>(id));
+	}
+
+	static size_t FindSlot(const char *text, size_t length, uint32_t hash)
+	{
+		if (slots.empty())
+			return slots.size();
+		const size_t mask = slots.size() - 1;
+		for (size_t i = Home(hash); slots[i] != EMPTY_SLOT; i = (i + 1) & mask)
+		{
+			const Entry &entry = entries[slots[i]];
+			if (entry.hash == hash && entry.length == length && memcmp(entry.text, text, length) == 0)
+				return i;
+		}
+		return slots.size();
+	}
+
+	static void RemoveSlot(size_t slot_index)
+	{ // Backward shift deletion, like the index of the vectors.
+		const size_t mask = slots.size() - 1;
+		size_t hole = slot_index;
+		for (size_t i = (hole + 1) & mask; slots[i] != EMPTY_SLOT; i = (i + 1) & mask)
+		{
+			const size_t home = Home(entries[slots[i]].hash);
+			if (((i - home) & mask) >= ((i - hole) & mask))
+			{
+				slots[hole] = slots[i];
+				hole = i;
+			}
+		}
+		slots[hole] = EMPTY_SLOT;
+	}
+
+	int Intern(const char *text, size_t length)
+	{
+		const uint32_t hash = Hash(text, length);
+		const size_t slot = FindSlot(text, length, hash);
+		if (slot != slots.size())
+			return slots[slot];
+
+		if ((count + 1) * 4 > slots.size() * 3)
+			Rehash(slots.empty() ? MIN_INDEX_CAPACITY : slots.size() * 2);
+		int id;
+		if (!free_ids.empty())
+		{
+			id = free_ids.back();
+			free_ids.pop_back();
+		}
+		else
+		{
+			id = static_cast<int>(entries.size());
+			entries.push_back(Entry());
+		}
+		Entry &entry = entries[id];
+		entry.text = static_cast<char *>(pool::Allocate(length + 1));
+		memcpy(entry.text, text, length);
+		entry.text[length] = '\0';
+		entry.length = static_cast<uint32_t>(length);
+		entry.hash = hash;
+		InsertSlot(id);
+		++count;
+		return id;
+	}
+
+	int Find(const char *text, size_t length)
+	{
+		const size_t slot = FindSlot(text, length, Hash(text, length));
+		return slot != slots.size() ? slots[slot] : -1;
+	}
+
+	const char *Get(int id)
+	{
+		if (id < 0 || static_cast<size_t>(id) >= entries.size())
+			return NULL;
+		return entries[id].text;
+	}
+
+	size_t Count()
+	{
+		return count;
+	}
+
+	size_t IdLimit()
+	{
+		return entries.size();
+	}
+
+	size_t Collect(const std::vector<bool> &live)
+	{
+		size_t freed = 0;
+		for (size_t id = 0; id < entries.size(); ++id)
+		{
+			Entry &entry = entries[id];
+			if (entry.text == NULL || (id < live.size() && live[id]))
+				continue;
+			RemoveSlot(FindSlot(entry.text, entry.length, entry.hash));
+			pool::Deallocate(entry.text, entry.length + 1);
+			entry.text = NULL;
+			free_ids.push_back(static_cast<int>(id));
+			++freed;
+		}
+		count -= freed;
+		return freed;
+	}
+
+	size_t MemoryUsage()
+	{
+		size_t bytes = entries.capacity() * sizeof(Entry) + free_ids.capacity() * sizeof(int) + slots.capacity() * sizeof(int32_t);
+		for (size_t id = 0; id < entries.size(); ++id)
+			if (entries[id].text != NULL)
+				bytes += entries[id].length + 1;
+		return bytes;
+	}
+
+}
@@ -0,0 +1,82 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+*/
+
+#ifndef _STRINGPOOL_H
+#define _STRINGPOOL_H
+
+#include <cstddef>
+#include <vector>
+
+
+/*
+	Plugin-wide pool of interned strings. Every distinct string is stored
+	once and known by a small integer ID, which is what string vectors hold:
+	comparing two strings of the pool is comparing their IDs.
+
+	The text of a string is allocated from the plugin-wide pool and found
+	through an open-addressing index on its hash. Strings aren't reference
+	counted, the owner of the IDs calls Collect() with the ones still in use
+	and the others are freed; their IDs are reused.
+
+	Only the server thread may use the pool.
+*/
+namespace stringpool
+{
+
+	/*
+		Returns the ID of the string, interning it if it isn't already.
+	*/
+	int Intern(const char *text, size_t length);
+
+	/*
+		Returns the ID of the string, or -1 if it isn't interned.
+	*/
+	int Find(const char *text, size_t length);
+
+	/*
+		Returns the NUL-terminated text of a string, or NULL if the ID isn't
+		in use.
+	*/
+	const char *Get(int id);
+
+	/*
+		Returns the number of strings interned, and one past the largest ID
+		handed out.
+	*/
+	size_t Count();
+	size_t IdLimit();
+
+	/*
+		Frees the strings whose ID isn't set in 'live' (indexed by ID, it may
+		be shorter than IdLimit()). Returns the number of strings freed.
+	*/
+	size_t Collect(const std::vector<bool> &live);
+
+	/*
+		Returns the number of bytes allocated for the texts and the index.
+	*/
+	size_t MemoryUsage();
+
+}
+
+
+#endif // _STRINGPOOL_H
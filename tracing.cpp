@@ -0,0 +1,179 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <map>
+#include <thread>
+#include "pluginconfig.h"
+#include "tracing.h"
+
+
+extern void *(*logprintf)(const char *fmt, ...);
+
+namespace tracing
+{
+
+	const char TRACE_FILE_NAME[] = "vectors_trace.log";
+
+	bool active = false;
+
+	// The ring must be a power of two in size.
+	static const size_t RING_SIZE = 4096;
+	static const size_t RECORD_TEXT_SIZE = 200;
+	static const std::chrono::milliseconds DRAIN_INTERVAL(20);
+
+	struct TraceRecord
+	{
+		std::chrono::steady_clock::time_point time;
+		const char *native;
+		char text[RECORD_TEXT_SIZE];
+	};
+
+	static TraceRecord ring[RING_SIZE];
+	static std::atomic<size_t> ring_head(0); // next record to write, owned by the server thread
+	static std::atomic<size_t> ring_tail(0); // next record to drain, owned by the writer thread
+	static std::atomic<size_t> dropped(0);
+
+	static std::thread writer;
+	static std::atomic<bool> writer_running(false);
+	static std::chrono::steady_clock::time_point start_time;
+
+	static std::map<std::string, Settings> settings_by_native;
+	static unsigned int default_sample_rate = 0;
+
+	Point::Point(const char *native) : native(native), counter(0)
+	{
+		Settings defaults;
+		defaults.sample_rate = default_sample_rate;
+		settings = &settings_by_native.insert(std::make_pair(std::string(native), defaults)).first->second;
+	}
+
+	void Point::Record(const char *fmt, ...)
+	{
+		const size_t head = ring_head.load(std::memory_order_relaxed);
+		if (head - ring_tail.load(std::memory_order_acquire) >= RING_SIZE)
+		{
+			dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		TraceRecord &record = ring[head & (RING_SIZE - 1)];
+		record.time = std::chrono::steady_clock::now();
+		record.native = native;
+		va_list args;
+		va_start(args, fmt);
+		vsnprintf(record.text, sizeof(record.text), fmt, args);
+		va_end(args);
+		ring_head.store(head + 1, std::memory_order_release);
+	}
+
+	static void Drain(FILE *file, size_t &dropped_reported)
+	{
+		size_t tail = ring_tail.load(std::memory_order_relaxed);
+		const size_t head = ring_head.load(std::memory_order_acquire);
+		for (; tail != head; ++tail)
+		{
+			const TraceRecord &record = ring[tail & (RING_SIZE - 1)];
+			const double ms = std::chrono::duration<double, std::milli>(record.time - start_time).count();
+			fprintf(file, "[%12.3f] %s: %s\n", ms, record.native, record.text);
+		}
+		ring_tail.store(tail, std::memory_order_release);
+
+		const size_t dropped_now = dropped.load(std::memory_order_relaxed);
+		if (dropped_now != dropped_reported)
+		{
+			fprintf(file, "%u records were dropped, the trace buffer was full.\n", static_cast<unsigned int>(dropped_now - dropped_reported));
+			dropped_reported = dropped_now;
+		}
+		fflush(file);
+	}
+
+	static void WriterThread(FILE *file)
+	{
+		size_t dropped_reported = dropped.load();
+		while (writer_running.load(std::memory_order_acquire))
+		{
+			Drain(file, dropped_reported);
+			std::this_thread::sleep_for(DRAIN_INTERVAL);
+		}
+		Drain(file, dropped_reported);
+		fclose(file);
+	}
+
+	void Start()
+	{
+		if (writer_running.load())
+			return;
+		FILE *file = fopen(TRACE_FILE_NAME, "a");
+		if (file == NULL)
+		{
+			logprintf("%s: Could not open the trace file \"%s\".", PLUGIN_NAME, TRACE_FILE_NAME);
+			return;
+		}
+		start_time = std::chrono::steady_clock::now();
+		writer_running.store(true);
+		writer = std::thread(WriterThread, file);
+	}
+
+	void Stop()
+	{
+		if (!writer_running.load())
+			return;
+		writer_running.store(false);
+		writer.join();
+	}
+
+	static void UpdateActive()
+	{
+		active = (default_sample_rate != 0);
+		for (auto it = settings_by_native.begin(); !active && it != settings_by_native.end(); ++it)
+			active = (it->second.sample_rate != 0);
+		// The writer only runs while something is traced.
+		if (active)
+			Start();
+		else
+			Stop();
+	}
+
+	void SetNative(const std::string &native, unsigned int sample_rate)
+	{
+		settings_by_native[native].sample_rate = sample_rate;
+		UpdateActive();
+	}
+
+	void SetAll(unsigned int sample_rate)
+	{
+		default_sample_rate = sample_rate;
+		for (auto it = settings_by_native.begin(); it != settings_by_native.end(); ++it)
+			it->second.sample_rate = sample_rate;
+		UpdateActive();
+	}
+
+	size_t GetDropped()
+	{
+		return dropped.load();
+	}
+
+}
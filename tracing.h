@@ -0,0 +1,124 @@
+/*
+	Copyright (c) 2021 Andrei "SkuZZi" Sebastian
+
+	Permission is hereby granted, free of charge, to any person obtaining a copy
+	of this software and associated documentation files (the "Software"), to deal
+	in the Software without restriction, including without limitation the rights
+	to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+	copies of the Software, and to permit persons to whom the Software is
+	furnished to do so, subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be included in all
+	copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+	IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+	FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+	AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+	LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+	OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+	SOFTWARE.
+
+*/
+
+#ifndef _TRACING_H
+#define _TRACING_H
+
+#include <cstddef>
+#include <string>
+
+
+/*
+	Tracing of the natives, replacing the synchronous logprintf debug output.
+
+	Every TRACE() site owns a static trace point bound to the settings of its
+	native: whether it's traced and the sampling rate (one of every N calls).
+	A sampled call formats its record into a lock-free single-producer ring
+	buffer; a background thread drains the buffer into TRACE_FILE_NAME. The
+	thread is started when the first native gets traced and joined when
+	tracing is disabled for all of them.
+	When the buffer is full records are dropped and counted, the server
+	thread never waits.
+
+	Building with DISABLE_TRACING compiles every TRACE() site out.
+*/
+namespace tracing
+{
+
+	extern const char TRACE_FILE_NAME[];
+
+	struct Settings
+	{
+		unsigned int sample_rate; // 0 = not traced
+	};
+
+	/*
+		Whether any native is traced, checked before anything else.
+	*/
+	extern bool active;
+
+	class Point
+	{
+	public:
+		explicit Point(const char *native);
+
+		bool Sample()
+		{
+			if (settings->sample_rate == 0)
+				return false;
+			return (++counter % settings->sample_rate) == 0;
+		}
+
+		void Record(const char *fmt, ...)
+#if defined __GNUC__
+			__attribute__((format(printf, 2, 3)))
+#endif
+			;
+
+	private:
+		const char *native;
+		const Settings *settings;
+		unsigned int counter;
+	};
+
+	/*
+		Starts and stops the thread writing the records to the trace file.
+		Stop() writes the remaining records first.
+	*/
+	void Start();
+	void Stop();
+
+	/*
+		Sets the sampling rate of one native, or of all of them (including the
+		ones set individually before). A rate of 0 disables tracing.
+	*/
+	void SetNative(const std::string &native, unsigned int sample_rate);
+	void SetAll(unsigned int sample_rate);
+
+	/*
+		Returns the number of records dropped because the buffer was full.
+	*/
+	size_t GetDropped();
+
+}
+
+#if defined DISABLE_TRACING
+	namespace tracing
+	{
+		inline void Ignore(const char *, ...) {}
+	}
+	// The arguments are never evaluated, but still count as used.
+	#define TRACE(native, ...) do { if (false) tracing::Ignore(__VA_ARGS__); } while (0)
+#else
+	#define TRACE(native, ...) \
+		do { \
+			if (tracing::active) { \
+				static tracing::Point trace_point(native); \
+				if (trace_point.Sample()) \
+					trace_point.Record(__VA_ARGS__); \
+			} \
+		} while (0)
+#endif
+
+
+#endif // _TRACING_H